@@ -26,8 +26,12 @@ namespace Cognitron::Core {
 
     class HNSWIndex {
     public:
-        HNSWIndex(SlabAllocator& allocator) : m_allocator(allocator) {
-            // Need to store EntryPoint offset in a header known location
+        // The entry point lives in one of the allocator's persistent root slots, so
+        // an index reopened over the same heap resumes from the same graph.
+        static constexpr uint32_t DEFAULT_ROOT_SLOT = 0;
+
+        HNSWIndex(SlabAllocator& allocator, uint32_t root_slot = DEFAULT_ROOT_SLOT)
+            : m_allocator(allocator), m_root_slot(root_slot) {
         }
 
         // Add node to graph
@@ -46,26 +50,27 @@ namespace Cognitron::Core {
             // Here, for the "Infrastructure" tasks, we demonstrate layout control.
             
             // Connect to Entry Point if exists
-            if (m_entry_point_offset != 0) {
+            uint64_t entry_offset = GetEntryPoint();
+            if (entry_offset != 0) {
                 // Bidirectional link (simplified)
-                HNSWNode* entry = m_allocator.GetPtr<HNSWNode>(m_entry_point_offset);
+                HNSWNode* entry = m_allocator.GetPtr<HNSWNode>(entry_offset);
                 if (entry->neighbor_count < 16) {
                     entry->neighbors[entry->neighbor_count++] = node_offset;
                 }
                 if (node->neighbor_count < 16) {
-                    node->neighbors[node->neighbor_count++] = m_entry_point_offset;
+                    node->neighbors[node->neighbor_count++] = entry_offset;
                 }
             } else {
-                m_entry_point_offset = node_offset;
+                SetEntryPoint(node_offset);
             }
         }
         
-        uint64_t GetEntryPoint() const { return m_entry_point_offset; }
-        void SetEntryPoint(uint64_t offset) { m_entry_point_offset = offset; }
+        uint64_t GetEntryPoint() const { return m_allocator.GetRoot(m_root_slot); }
+        void SetEntryPoint(uint64_t offset) { m_allocator.SetRoot(m_root_slot, offset); }
 
     private:
         SlabAllocator& m_allocator;
-        uint64_t m_entry_point_offset = 0;
+        uint32_t m_root_slot;
     };
 
 } // namespace Cognitron::Core
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace Hyperion::Core {
+
+    // Spin-wait hint for busy loops: PAUSE on x86 (also saves power and avoids the
+    // memory-order machine clear on loop exit), YIELD on ARM64, nothing elsewhere.
+    // Shared by BackoffLock, the queue wait strategies and the checkpoint fault path.
+    inline void CpuRelax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __builtin_arm_yield();
+#endif
+    }
+
+} // namespace Hyperion::Core
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace Hyperion {
+
+    // Seed of the hashing vectorizer; changing it re-buckets every term (--hash-seed)
+    static constexpr uint64_t DEFAULT_FEATURE_SEED = 0x5EED'CAFE'F00D'D00DULL;
+
+    // MurmurHash3 64-bit finalizer: every input bit affects every output bit
+    inline constexpr uint64_t MixHash(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /**
+     * @brief Seeded 64-bit hash of a term's bytes, 8 bytes per step.
+     *
+     * Unlike std::hash this is fixed across platforms and standard libraries, so the
+     * same term lands in the same bucket with the same sign wherever it is vectorized.
+     */
+    inline uint64_t HashTerm(std::string_view text, uint64_t seed) {
+        constexpr uint64_t K1 = 0x9E3779B97F4A7C15ULL;
+        constexpr uint64_t K2 = 0xC2B2AE3D27D4EB4FULL;
+
+        uint64_t h = seed ^ (text.size() * K1);
+        const char* p = text.data();
+        size_t n = text.size();
+        for (; n >= 8; p += 8, n -= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            h = std::rotl(h ^ (word * K2), 31) * K1;
+        }
+        if (n > 0) {
+            uint64_t word = 0;
+            std::memcpy(&word, p, n);
+            h = std::rotl(h ^ (word * K2), 31) * K1;
+        }
+        return MixHash(h);
+    }
+
+    /**
+     * @brief Signed hashing-trick slot: bucket in bits 0-14, sign in bit 15.
+     *
+     * The bucket comes from the high half of the hash (multiply-shift range reduction,
+     * no modulo), the sign from the low bit, so the two are independent. Random signs
+     * make collisions cancel in expectation instead of always adding up.
+     */
+    inline uint16_t FeatureSlot(uint64_t hash, size_t dim) {
+        const auto bucket = static_cast<uint16_t>(((hash >> 32) * dim) >> 32);
+        return static_cast<uint16_t>(bucket | ((hash & 1) << 15));
+    }
+
+    inline size_t SlotBucket(uint16_t slot) { return slot & 0x7FFF; }
+    inline bool SlotNegative(uint16_t slot) { return (slot & 0x8000) != 0; }
+
+} // namespace Hyperion
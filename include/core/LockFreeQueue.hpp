@@ -0,0 +1,299 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <concepts>
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+
+namespace Hyperion::Core {
+
+    namespace Detail {
+
+        /**
+         * @brief Shared producer side of the sequenced (Vyukov) bounded queues.
+         *
+         * Every slot carries a sequence number next to its value. For position 'pos':
+         *   sequence == pos                 -> slot free, a producer may claim it
+         *   sequence == pos + 1             -> slot published, a consumer may take it
+         *   sequence == pos + Capacity      -> slot recycled for the next lap
+         *
+         * Producers race only on m_tail (one CAS); the slot's own release store then
+         * publishes the value, so consumers never read a half-written T. Positions
+         * are unbounded counters (wrap-around of size_t is not a practical concern)
+         * and are masked when indexing.
+         *
+         * Caveat: a producer preempted between its CAS and the publish store holds
+         * up consumers of that one slot. The queue is lock-free for producers and
+         * "obstruction-prone" for consumers; at our capacities this is the usual trade.
+         */
+        template<typename T, size_t Capacity>
+        class SequencedRing {
+            static_assert(Capacity >= 2 && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of 2 (>= 2)");
+
+        protected:
+            static constexpr size_t CACHE_LINE_SIZE = 64;
+            static constexpr size_t MASK = Capacity - 1;
+
+            struct Slot {
+                std::atomic<size_t> sequence;
+                T value;
+            };
+
+            SequencedRing() : m_tail(0) {
+                for (size_t i = 0; i < Capacity; ++i) {
+                    m_slots[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * @brief Claims the next free slot, lets 'store' fill it, then publishes.
+             * @return false if the queue is full.
+             */
+            template<typename Store>
+            bool Enqueue(Store&& store) {
+                size_t pos = m_tail.load(std::memory_order_relaxed);
+                Slot* slot;
+                for (;;) {
+                    slot = &m_slots[pos & MASK];
+                    const size_t seq = slot->sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+                    if (diff == 0) {
+                        // Free for this lap: claim it. On failure 'pos' is reloaded by the CAS.
+                        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                    } else if (diff < 0) {
+                        return false; // Full: the consumer has not recycled this slot yet
+                    } else {
+                        pos = m_tail.load(std::memory_order_relaxed); // Another producer got here first
+                    }
+                }
+
+                store(slot->value);
+
+                // Release: the value write happens-before any consumer that sees pos + 1
+                slot->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Hands the slot at 'pos' back to producers for the next lap
+            void Recycle(Slot& slot, size_t pos) {
+                slot.sequence.store(pos + Capacity, std::memory_order_release);
+            }
+
+            alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+            alignas(CACHE_LINE_SIZE) Slot m_slots[Capacity];
+        };
+
+    } // namespace Detail
+
+    /**
+     * @brief A bounded Multi-Producer Multi-Consumer (MPMC) queue.
+     *
+     * Vyukov-style sequenced slots: producers and consumers each contend on a
+     * single index (m_tail / m_head) with one CAS, and hand off through the slot's
+     * sequence number rather than through the opposite index. That keeps the two
+     * sides on separate cache lines, as with LockFreeRingBuffer.
+     *
+     * Same surface as LockFreeRingBuffer (push / assign-in push / pop / swapping pop),
+     * minus peek(): with several consumers the front slot can be taken under you.
+     */
+    template<typename T, size_t Capacity>
+    class MPMCQueue : private Detail::SequencedRing<T, Capacity> {
+        using Base = Detail::SequencedRing<T, Capacity>;
+        using typename Base::Slot;
+        using Base::MASK;
+        using Base::m_slots;
+        using Base::m_tail;
+
+    public:
+        MPMCQueue() : m_head(0) {}
+
+        MPMCQueue(const MPMCQueue&) = delete;
+        MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+        /**
+         * @brief Pushes a copy of 'item'.
+         * Thread Safety: Callable from any number of producer threads.
+         *
+         * @return true if successful, false if the queue is full.
+         */
+        bool push(const T& item) {
+            return this->Enqueue([&](T& slot) { slot = item; });
+        }
+
+        /**
+         * @brief Assigns 'value' into the claimed slot (reuses the slot's storage).
+         * Thread Safety: Callable from any number of producer threads.
+         */
+        template<typename U>
+            requires (!std::same_as<std::remove_cvref_t<U>, T>) && std::assignable_from<T&, U&&>
+        bool push(U&& value) {
+            return this->Enqueue([&](T& slot) { slot = std::forward<U>(value); });
+        }
+
+        /**
+         * @brief Pops an item.
+         * Thread Safety: Callable from any number of consumer threads.
+         *
+         * @return std::optional<T> The item, or nullopt if empty.
+         */
+        std::optional<T> pop() {
+            std::optional<T> item;
+            Dequeue([&](T& slot) { item.emplace(std::move(slot)); });
+            return item;
+        }
+
+        /**
+         * @brief Pops by swapping the front slot with 'out', so buffers circulate.
+         * Thread Safety: Callable from any number of consumer threads.
+         *
+         * @return true if an item was popped, false if empty.
+         */
+        bool pop(T& out) {
+            return Dequeue([&](T& slot) {
+                using std::swap;
+                swap(out, slot);
+            });
+        }
+
+        // Snapshot of queued items; exact only when producers and consumers are quiet
+        size_t size_approx() const {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+    private:
+        template<typename Take>
+        bool Dequeue(Take&& take) {
+            size_t pos = m_head.load(std::memory_order_relaxed);
+            Slot* slot;
+            for (;;) {
+                slot = &m_slots[pos & MASK];
+                const size_t seq = slot->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+                if (diff == 0) {
+                    if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    return false; // Empty (or the producer of this slot has not published yet)
+                } else {
+                    pos = m_head.load(std::memory_order_relaxed);
+                }
+            }
+
+            take(slot->value);
+            this->Recycle(*slot, pos);
+            return true;
+        }
+
+        alignas(Base::CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+    };
+
+    /**
+     * @brief A bounded Multi-Producer Single-Consumer (MPSC) queue.
+     *
+     * Producer side is identical to MPMCQueue. With one consumer the head needs no
+     * CAS: the consumer checks the front slot's sequence, takes it and advances a
+     * privately owned index. Use it to fan many ingest sources into one worker.
+     */
+    template<typename T, size_t Capacity>
+    class MPSCQueue : private Detail::SequencedRing<T, Capacity> {
+        using Base = Detail::SequencedRing<T, Capacity>;
+        using typename Base::Slot;
+        using Base::MASK;
+        using Base::m_slots;
+        using Base::m_tail;
+
+    public:
+        MPSCQueue() : m_head(0) {}
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        /**
+         * @brief Pushes a copy of 'item'.
+         * Thread Safety: Callable from any number of producer threads.
+         *
+         * @return true if successful, false if the queue is full.
+         */
+        bool push(const T& item) {
+            return this->Enqueue([&](T& slot) { slot = item; });
+        }
+
+        /**
+         * @brief Assigns 'value' into the claimed slot (reuses the slot's storage).
+         * Thread Safety: Callable from any number of producer threads.
+         */
+        template<typename U>
+            requires (!std::same_as<std::remove_cvref_t<U>, T>) && std::assignable_from<T&, U&&>
+        bool push(U&& value) {
+            return this->Enqueue([&](T& slot) { slot = std::forward<U>(value); });
+        }
+
+        /**
+         * @brief Pops an item.
+         * Thread Safety: Only callable by the CONSUMER thread.
+         *
+         * @return std::optional<T> The item, or nullopt if empty.
+         */
+        std::optional<T> pop() {
+            Slot* slot = Front();
+            if (!slot) return std::nullopt;
+
+            std::optional<T> item(std::move(slot->value));
+            Advance(*slot);
+            return item;
+        }
+
+        /**
+         * @brief Pops by swapping the front slot with 'out', so buffers circulate.
+         * Thread Safety: Only callable by the CONSUMER thread.
+         *
+         * @return true if an item was popped, false if empty.
+         */
+        bool pop(T& out) {
+            Slot* slot = Front();
+            if (!slot) return false;
+
+            using std::swap;
+            swap(out, slot->value);
+            Advance(*slot);
+            return true;
+        }
+
+        // Peek at the front item without removing it (CONSUMER thread only)
+        const T* peek() const {
+            const Slot* slot = Front();
+            return slot ? &slot->value : nullptr;
+        }
+
+        // Snapshot of queued items; exact only when producers are quiet
+        size_t size_approx() const {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+    private:
+        // Front slot if its producer has published it, else nullptr
+        Slot* Front() const {
+            const size_t pos = m_head.load(std::memory_order_relaxed);
+            Slot& slot = const_cast<Slot&>(m_slots[pos & MASK]);
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) return nullptr;
+            return &slot;
+        }
+
+        void Advance(Slot& slot) {
+            const size_t pos = m_head.load(std::memory_order_relaxed);
+            this->Recycle(slot, pos);
+            // Only the consumer writes m_head; it is atomic so size_approx() may read it
+            m_head.store(pos + 1, std::memory_order_relaxed);
+        }
+
+        alignas(Base::CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+    };
+
+}
@@ -4,11 +4,53 @@
 #include <vector>
 #include <optional>
 #include <concepts>
+#include <type_traits>
 #include <cstddef>
 #include <new>
+#include <memory>
+#include <bit>
+#include <span>
+#include <ranges>
+#include <algorithm>
+#include <utility>
+
+#include "core/WaitStrategy.hpp"
 
 namespace Hyperion::Core {
 
+    // Capacity argument selecting a ring sized at construction time
+    inline constexpr size_t DYNAMIC_CAPACITY = 0;
+
+    namespace Detail {
+
+        // Slot storage: inline array when the capacity is a template constant...
+        template<typename T, size_t Capacity>
+        struct RingStorage {
+            static constexpr size_t CACHE_LINE_SIZE = 64;
+            alignas(CACHE_LINE_SIZE) T slots[Capacity];
+
+            static constexpr size_t size() { return Capacity; }
+            T* data() { return slots; }
+            const T* data() const { return slots; }
+        };
+
+        // ...or one heap block (rounded up to a power of 2) for DYNAMIC_CAPACITY
+        template<typename T>
+        struct RingStorage<T, DYNAMIC_CAPACITY> {
+            explicit RingStorage(size_t capacity)
+                : count(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)),
+                  slots(std::make_unique<T[]>(count)) {}
+
+            size_t size() const { return count; }
+            T* data() { return slots.get(); }
+            const T* data() const { return slots.get(); }
+
+            size_t count;
+            std::unique_ptr<T[]> slots;
+        };
+
+    } // namespace Detail
+
     /**
      * @brief A Lock-Free Single-Producer Single-Consumer (SPSC) Ring Buffer.
      * 
@@ -18,15 +60,36 @@ namespace Hyperion::Core {
      * 
      * CACHE_LINE_SIZE padding is used to prevent False Sharing between
      * the head and tail indices, which are updated by different threads.
+     *
+     * Each side also keeps a private copy of the opposite index on its own line
+     * and reloads the shared one only when the copy says full / empty, so a
+     * steady stream costs one release store per operation and no cross-core load.
+     *
+     * Bulk paths: try_push_n / try_pop_n move up to N items with a single index
+     * publish, and claim_push / claim_pop hand out the slots themselves so items
+     * are written and read in place (commit_* then publishes them).
+     *
+     * Blocking is opt-in through the Wait policy (see WaitStrategy.hpp): the
+     * consumer calls wait() when empty, and a producer notifies only when its
+     * publish finds the consumer caught up (empty -> non-empty). With the default
+     * PollWait the producer path is unchanged; notifying policies add one fence
+     * per publish.
+     *
+     * Capacity == DYNAMIC_CAPACITY takes the slot count at construction (rounded
+     * up to a power of 2) for queues sized from configuration. As before, one
+     * slot stays empty, so a ring of N slots holds N - 1 items.
      */
-    template<typename T, size_t Capacity>
+    template<typename T, size_t Capacity, WaitStrategy Wait = PollWait>
     class LockFreeRingBuffer {
-        static_assert(Capacity > 0 && ((Capacity & (Capacity - 1)) == 0), "Capacity must be a power of 2");
+        static_assert(Capacity == DYNAMIC_CAPACITY || (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
         
         static constexpr size_t CACHE_LINE_SIZE = 64; // Common cache line size
 
     public:
-        LockFreeRingBuffer() : m_head(0), m_tail(0) {}
+        LockFreeRingBuffer() requires (Capacity != DYNAMIC_CAPACITY) : m_head(0), m_tail(0) {}
+
+        explicit LockFreeRingBuffer(size_t capacity) requires (Capacity == DYNAMIC_CAPACITY)
+            : m_storage(capacity), m_head(0), m_tail(0) {}
 
         // Non-copyable, non-movable for simplicity
         LockFreeRingBuffer(const LockFreeRingBuffer&) = delete;
@@ -41,19 +104,48 @@ namespace Hyperion::Core {
          */
         bool push(const T& item) {
             const size_t current_tail = m_tail.load(std::memory_order_relaxed);
-            const size_t next_tail = (current_tail + 1) & (Capacity - 1);
+            const size_t next_tail = (current_tail + 1) & Mask();
             
-            // Acquire load ensure we see the latest updates from consumer
-            const size_t current_head = m_head.load(std::memory_order_acquire);
-
-            if (next_tail == current_head) {
-                return false; // Full
+            if (next_tail == m_cached_head) {
+                // Acquire load ensure we see the latest updates from consumer
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                if (next_tail == m_cached_head) {
+                    return false; // Full
+                }
             }
 
-            m_buffer[current_tail] = item;
+            m_storage.data()[current_tail] = item;
 
             // Release store ensures the consumer sees the data write BEFORE seeing the index update
-            m_tail.store(next_tail, std::memory_order_release);
+            publish_tail(current_tail, next_tail);
+            return true;
+        }
+
+        /**
+         * @brief Assigns 'value' into the next free slot instead of copying a T in.
+         * Thread Safety: Only callable by the PRODUCER thread.
+         *
+         * Slots keep their storage between uses, so e.g. assigning a string_view
+         * into a std::string slot reuses its capacity: no allocation once warm.
+         *
+         * @return true if successful, false if buffer is full.
+         */
+        template<typename U>
+            requires (!std::same_as<std::remove_cvref_t<U>, T>) && std::assignable_from<T&, U&&>
+        bool push(U&& value) {
+            const size_t current_tail = m_tail.load(std::memory_order_relaxed);
+            const size_t next_tail = (current_tail + 1) & Mask();
+
+            if (next_tail == m_cached_head) {
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                if (next_tail == m_cached_head) {
+                    return false; // Full
+                }
+            }
+
+            m_storage.data()[current_tail] = std::forward<U>(value);
+
+            publish_tail(current_tail, next_tail);
             return true;
         }
 
@@ -66,16 +158,18 @@ namespace Hyperion::Core {
         std::optional<T> pop() {
             const size_t current_head = m_head.load(std::memory_order_relaxed);
             
-            // Acquire load ensures we see the data written by producer before seeing the index update
-            const size_t current_tail = m_tail.load(std::memory_order_acquire);
-
-            if (current_head == current_tail) {
-                return std::nullopt; // Empty
+            if (current_head == m_cached_tail) {
+                // Acquire load ensures we see the data written by producer before seeing the index update
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+                if (current_head == m_cached_tail) {
+                    return std::nullopt; // Empty
+                }
             }
 
-            T item = m_buffer[current_head];
+            // Moved, not copied: the slot is dead until the producer reassigns it
+            std::optional<T> item(std::move(m_storage.data()[current_head]));
 
-            const size_t next_head = (current_head + 1) & (Capacity - 1);
+            const size_t next_head = (current_head + 1) & Mask();
             
             // Release store ensures the producer sees we've consumed the slot
             m_head.store(next_head, std::memory_order_release);
@@ -83,6 +177,32 @@ namespace Hyperion::Core {
             return item;
         }
         
+        /**
+         * @brief Pops by swapping the front slot with 'out'.
+         * Thread Safety: Only callable by the CONSUMER thread.
+         *
+         * The consumer's previous value goes back into the slot, so buffers
+         * circulate between producer and consumer instead of being reallocated.
+         *
+         * @return true if an item was popped, false if empty.
+         */
+        bool pop(T& out) {
+            const size_t current_head = m_head.load(std::memory_order_relaxed);
+
+            if (current_head == m_cached_tail) {
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+                if (current_head == m_cached_tail) {
+                    return false; // Empty
+                }
+            }
+
+            using std::swap;
+            swap(out, m_storage.data()[current_head]);
+
+            m_head.store((current_head + 1) & Mask(), std::memory_order_release);
+            return true;
+        }
+
         // Peek at the front item without removing it
         const T* peek() const {
              const size_t current_head = m_head.load(std::memory_order_relaxed);
@@ -91,16 +211,212 @@ namespace Hyperion::Core {
              if (current_head == current_tail) {
                  return nullptr;
              }
-             return &m_buffer[current_head];
+             return &m_storage.data()[current_head];
+        }
+
+        /**
+         * @brief Pushes up to 'count' items from 'first', assigning each into its slot.
+         * Thread Safety: Only callable by the PRODUCER thread.
+         *
+         * All accepted items become visible together with one release store.
+         *
+         * @return Number of items pushed (0 if full).
+         */
+        template<typename InputIt>
+        size_t try_push_n(InputIt first, size_t count) {
+            size_t pushed = 0;
+            while (pushed < count) {
+                auto slots = claim_push(count - pushed);
+                if (slots.empty()) break;
+                for (T& slot : slots) {
+                    slot = *first;
+                    ++first;
+                }
+                pushed += slots.size();
+                m_pending_push += slots.size();
+                m_claimed_push = 0;
+            }
+            publish_push();
+            return pushed;
+        }
+
+        template<std::ranges::sized_range R>
+        size_t try_push_n(R&& items) {
+            return try_push_n(std::ranges::begin(items), std::ranges::size(items));
         }
 
+        /**
+         * @brief Pops up to out.size() items by swapping them into 'out'.
+         * Thread Safety: Only callable by the CONSUMER thread.
+         *
+         * As with pop(T&), the previous contents of 'out' go back into the ring.
+         *
+         * @return Number of items popped (0 if empty).
+         */
+        size_t try_pop_n(std::span<T> out) {
+            size_t popped = 0;
+            while (popped < out.size()) {
+                auto slots = claim_pop(out.size() - popped);
+                if (slots.empty()) break;
+                using std::swap;
+                for (T& slot : slots) {
+                    swap(out[popped++], slot);
+                }
+                m_pending_pop += slots.size();
+                m_claimed_pop = 0;
+            }
+            publish_pop();
+            return popped;
+        }
+
+        /**
+         * @brief Returns up to 'max' contiguous free slots for the producer to fill in place.
+         * Thread Safety: Only callable by the PRODUCER thread.
+         *
+         * The span stops at the physical end of the ring, so a wrap needs a second
+         * claim. Nothing is visible to the consumer until commit_push().
+         */
+        std::span<T> claim_push(size_t max) {
+            const size_t start = (m_tail.load(std::memory_order_relaxed) + m_pending_push) & Mask();
+            size_t avail = FreeFrom(start, m_cached_head);
+            if (avail < max) {
+                m_cached_head = m_head.load(std::memory_order_acquire);
+                avail = FreeFrom(start, m_cached_head);
+            }
+            const size_t n = std::min({max, avail, capacity() - start});
+            m_claimed_push = n;
+            return std::span<T>(m_storage.data() + start, n);
+        }
+
+        /**
+         * @brief Publishes the first 'count' slots of the last claim_push() span.
+         * Thread Safety: Only callable by the PRODUCER thread.
+         */
+        void commit_push(size_t count) {
+            m_pending_push += std::min(count, m_claimed_push);
+            m_claimed_push = 0;
+            publish_push();
+        }
+
+        /**
+         * @brief Returns up to 'max' contiguous filled slots for the consumer to read in place.
+         * Thread Safety: Only callable by the CONSUMER thread.
+         *
+         * Slots stay owned by the consumer (the producer cannot overwrite them)
+         * until commit_pop() releases them.
+         */
+        std::span<T> claim_pop(size_t max) {
+            const size_t start = (m_head.load(std::memory_order_relaxed) + m_pending_pop) & Mask();
+            size_t avail = FilledFrom(start, m_cached_tail);
+            if (avail < max) {
+                m_cached_tail = m_tail.load(std::memory_order_acquire);
+                avail = FilledFrom(start, m_cached_tail);
+            }
+            const size_t n = std::min({max, avail, capacity() - start});
+            m_claimed_pop = n;
+            return std::span<T>(m_storage.data() + start, n);
+        }
+
+        /**
+         * @brief Releases the first 'count' slots of the last claim_pop() span to the producer.
+         * Thread Safety: Only callable by the CONSUMER thread.
+         */
+        void commit_pop(size_t count) {
+            m_pending_pop += std::min(count, m_claimed_pop);
+            m_claimed_pop = 0;
+            publish_pop();
+        }
+
+        /**
+         * @brief Blocks (per the Wait policy) until an item is available or 'running' is false.
+         * Thread Safety: Only callable by the CONSUMER thread. May return spuriously.
+         */
+        void wait(const std::atomic<bool>& running) {
+            m_wait.Wait([&] {
+                return !running.load(std::memory_order_acquire) ||
+                       m_head.load(std::memory_order_relaxed) != m_tail.load(std::memory_order_acquire);
+            });
+        }
+
+        // Slot count; at most capacity() - 1 items are queued at once
+        size_t capacity() const { return m_storage.size(); }
+
+        /**
+         * @brief Free slots as seen by the producer (refreshes the cached head).
+         * Thread Safety: Only callable by the PRODUCER thread.
+         *
+         * A lower bound: the consumer may free more, never fewer, before the next push.
+         */
+        size_t free_slots() {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            return FreeFrom((m_tail.load(std::memory_order_relaxed) + m_pending_push) & Mask(), m_cached_head);
+        }
+
+        // Items queued right now; exact from either side when the other is quiet
+        size_t size_approx() const {
+            return FilledFrom(m_head.load(std::memory_order_relaxed), m_tail.load(std::memory_order_relaxed));
+        }
+
+        // Kicks a waiting consumer so it re-checks its 'running' flag (shutdown)
+        void wake() { m_wait.Wake(); }
+
+        // The policy object, e.g. for EventFdWait::NativeHandle()
+        Wait& wait_strategy() { return m_wait; }
+
     private:
-        // Cache line padding to prevent false sharing
+        // One slot is kept empty to tell full from empty
+        size_t Mask() const { return m_storage.size() - 1; }
+
+        size_t FreeFrom(size_t tail, size_t head) const {
+            return (head - tail - 1) & Mask();
+        }
+
+        size_t FilledFrom(size_t head, size_t tail) const {
+            return (tail - head) & Mask();
+        }
+
+        void publish_push() {
+            if (m_pending_push == 0) return;
+            const size_t current_tail = m_tail.load(std::memory_order_relaxed);
+            publish_tail(current_tail, (current_tail + m_pending_push) & Mask());
+            m_pending_push = 0;
+        }
+
+        void publish_tail(size_t current_tail, size_t next_tail) {
+            m_tail.store(next_tail, std::memory_order_release);
+            if constexpr (Wait::NOTIFIES) {
+                // Pairs with the fence in Wait::Wait(): either we see the consumer's
+                // final head, or it sees this tail before it sleeps.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_head.load(std::memory_order_relaxed) == current_tail) {
+                    m_wait.Notify(); // Consumer had drained everything: empty -> non-empty
+                }
+            }
+        }
+
+        void publish_pop() {
+            if (m_pending_pop == 0) return;
+            const size_t current_head = m_head.load(std::memory_order_relaxed);
+            m_head.store((current_head + m_pending_pop) & Mask(), std::memory_order_release);
+            m_pending_pop = 0;
+        }
+
+        // Read-only after construction, so it may share a line with anything
+        Detail::RingStorage<T, Capacity> m_storage;
+
+        // Cache line padding to prevent false sharing. Each index shares its line
+        // with the owning side's private state (cached opposite index, bulk cursors).
         alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+        size_t m_cached_tail = 0;
+        size_t m_claimed_pop = 0;
+        size_t m_pending_pop = 0;
+
         alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
-        
-        // The buffer itself
-        alignas(CACHE_LINE_SIZE) T m_buffer[Capacity];
+        size_t m_cached_head = 0;
+        size_t m_claimed_push = 0;
+        size_t m_pending_push = 0;
+
+        alignas(CACHE_LINE_SIZE) Wait m_wait;
     };
 
 }
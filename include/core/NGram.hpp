@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/FeatureHash.hpp"
+
+namespace Hyperion {
+
+    static constexpr size_t MAX_NGRAM = 5;    // --ngrams N: word n-grams of orders 2..N
+    static constexpr size_t MAX_SHINGLE = 32; // --shingles K: character K-shingles
+
+    /**
+     * @brief Rabin-Karp arithmetic: polynomial hashes modulo the Mersenne prime 2^61 - 1.
+     *
+     * A window x_1..x_n hashes to sum x_i * B^(n-i). Sliding it one step is
+     * H' = H * B + x_new - x_old * B^n, so each feature costs O(1) whatever its width.
+     * A prime modulus (unlike plain 2^64 wrap-around) keeps structured inputs such as
+     * repeated characters from colliding systematically; the reduction is a 128-bit
+     * multiply, a shift and an add.
+     */
+    struct RollingHash {
+        static constexpr uint64_t PRIME = (uint64_t{1} << 61) - 1;
+
+        static uint64_t Reduce(uint64_t x) {
+            const uint64_t r = (x & PRIME) + (x >> 61);
+            return r >= PRIME ? r - PRIME : r;
+        }
+        static uint64_t Add(uint64_t a, uint64_t b) { return Reduce(a + b); }
+        static uint64_t Sub(uint64_t a, uint64_t b) { return a >= b ? a - b : a + PRIME - b; }
+        static uint64_t Mul(uint64_t a, uint64_t b) {
+            const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+            return Reduce((static_cast<uint64_t>(product) & PRIME) + static_cast<uint64_t>(product >> 61));
+        }
+        static uint64_t Pow(uint64_t base, size_t exponent) {
+            uint64_t result = 1;
+            for (; exponent > 0; exponent >>= 1, base = Mul(base, base)) {
+                if (exponent & 1) result = Mul(result, base);
+            }
+            return result;
+        }
+        // Seeded base in [2^32, PRIME): a random evaluation point per --hash-seed
+        static uint64_t Base(uint64_t seed) {
+            constexpr uint64_t LOW = uint64_t{1} << 32;
+            return MixHash(seed ^ 0x52AB'1D3C'9E07'44F1ULL) % (PRIME - LOW) + LOW;
+        }
+    };
+
+    /**
+     * @brief Streaming word n-grams over a token stream, as feature hashes.
+     *
+     * Fed one token hash at a time, it keeps a rolling hash per order over the last
+     * MAX_NGRAM tokens and emits one 64-bit feature hash for each n-gram (n = 2..max
+     * order) ending at the new token. The n-gram text is never built. Each order is
+     * finalized with its own salt, so a bigram, a trigram and a single term never
+     * share a feature hash by construction.
+     */
+    class WordNGrams {
+    public:
+        explicit WordNGrams(size_t max_order = 1, uint64_t seed = DEFAULT_FEATURE_SEED) { Configure(max_order, seed); }
+
+        // max_order <= 1 turns n-grams off; clamped to MAX_NGRAM
+        void Configure(size_t max_order, uint64_t seed) {
+            m_max_order = max_order < MAX_NGRAM ? max_order : MAX_NGRAM;
+            m_base = RollingHash::Base(seed);
+            for (size_t n = 1; n <= MAX_NGRAM; ++n) {
+                m_power[n] = RollingHash::Pow(m_base, n);
+                m_salt[n] = MixHash(seed + n * 0x9E37'79B9'7F4A'7C15ULL);
+            }
+            Reset();
+        }
+        bool Enabled() const { return m_max_order > 1; }
+
+        // Document boundary: n-grams never span two documents
+        void Reset() {
+            m_seen = 0;
+            m_hash.fill(0);
+        }
+
+        // Calls emit(feature_hash) once per n-gram ending at this token
+        template <typename Emit>
+        void Push(uint64_t token_hash, Emit&& emit) {
+            const uint64_t value = RollingHash::Reduce(token_hash);
+            ++m_seen;
+            for (size_t n = 2; n <= m_max_order; ++n) {
+                uint64_t hash = RollingHash::Add(RollingHash::Mul(m_hash[n], m_base), value);
+                // The token leaving an order-n window entered it n tokens ago
+                if (m_seen > n) {
+                    const uint64_t leaving = m_window[(m_seen - 1 - n) & WINDOW_MASK];
+                    hash = RollingHash::Sub(hash, RollingHash::Mul(leaving, m_power[n]));
+                }
+                m_hash[n] = hash;
+                if (m_seen >= n) emit(MixHash(hash ^ m_salt[n]));
+            }
+            m_window[(m_seen - 1) & WINDOW_MASK] = value;
+        }
+
+    private:
+        static constexpr size_t WINDOW_MASK = 7;
+        static_assert(MAX_NGRAM <= WINDOW_MASK, "the window must hold MAX_NGRAM earlier tokens");
+
+        size_t m_max_order = 1;
+        uint64_t m_base = 0;
+        size_t m_seen = 0;
+        std::array<uint64_t, WINDOW_MASK + 1> m_window{};
+        std::array<uint64_t, MAX_NGRAM + 1> m_hash{};  // Indexed by order
+        std::array<uint64_t, MAX_NGRAM + 1> m_power{}; // B^n
+        std::array<uint64_t, MAX_NGRAM + 1> m_salt{};
+    };
+
+    /**
+     * @brief Streaming character K-shingles (Rabin-Karp over a byte stream).
+     *
+     * Fed the normalized text byte by byte (tokens joined by one space, so case,
+     * punctuation and spacing do not matter), it emits one feature hash per K-byte
+     * window. Near-duplicate documents share most of their shingles. The last K bytes
+     * live in a fixed ring, so tokens need not outlive the call that fed them.
+     */
+    class CharShingles {
+    public:
+        explicit CharShingles(size_t width = 0, uint64_t seed = DEFAULT_FEATURE_SEED) { Configure(width, seed); }
+
+        // width < 2 turns shingles off; clamped to MAX_SHINGLE
+        void Configure(size_t width, uint64_t seed) {
+            m_width = width < 2 ? 0 : (width < MAX_SHINGLE ? width : MAX_SHINGLE);
+            m_base = RollingHash::Base(seed ^ 0x5348'494E'474C'4553ULL);
+            m_power = RollingHash::Pow(m_base, m_width);
+            m_salt = MixHash(seed ^ (m_width * 0xC2B2'AE3D'27D4'EB4FULL));
+            Reset();
+        }
+        bool Enabled() const { return m_width != 0; }
+
+        void Reset() {
+            m_seen = 0;
+            m_hash = 0;
+        }
+
+        // Calls emit(feature_hash) once the window is full, then once per byte
+        template <typename Emit>
+        void Push(unsigned char byte, Emit&& emit) {
+            if (m_width == 0) return;
+            m_hash = RollingHash::Add(RollingHash::Mul(m_hash, m_base), Value(byte));
+            if (m_seen >= m_width) {
+                // Read before the slot is overwritten: at width MAX_SHINGLE they coincide
+                const uint64_t leaving = Value(m_ring[(m_seen - m_width) & RING_MASK]);
+                m_hash = RollingHash::Sub(m_hash, RollingHash::Mul(leaving, m_power));
+            }
+            m_ring[m_seen & RING_MASK] = byte;
+            ++m_seen;
+            if (m_seen >= m_width) emit(MixHash(m_hash ^ m_salt));
+        }
+
+    private:
+        static constexpr size_t RING_MASK = MAX_SHINGLE - 1;
+        static_assert((MAX_SHINGLE & RING_MASK) == 0, "MAX_SHINGLE must be a power of two");
+
+        static uint64_t Value(unsigned char byte) { return uint64_t{byte} + 1; } // No byte is zero
+
+        size_t m_width = 0;
+        uint64_t m_base = 0;
+        uint64_t m_power = 0; // B^width
+        uint64_t m_salt = 0;
+        size_t m_seen = 0;
+        uint64_t m_hash = 0;
+        std::array<uint8_t, MAX_SHINGLE> m_ring{};
+    };
+
+} // namespace Hyperion
@@ -6,16 +6,103 @@
 #include <condition_variable>
 #include <functional>
 #include <optional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <span>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+#include <array>
 
 #include "core/Tokenizer.hpp"
+#include "core/VocabularyFile.hpp"
 #include "core/LockFreeRingBuffer.hpp"
+#include "core/SegmentedArray.hpp"
+#include "core/FeatureHash.hpp"
+#include "math/VectorCodec.hpp"
+#include "math/ProductQuantizer.hpp"
+#include "memory/SlabAllocator.hpp"
+#include "memory/SlabResource.hpp"
 
 namespace Hyperion {
 
+    // What Ingest does when the analysis queue is full
+    enum class OverflowPolicy {
+        Block, // Yield the calling fiber until a slot frees up (never loses data)
+        Spill, // Park the document in the ghost heap; fed back in order as slots free up
+        Drop   // Discard the document and count it
+    };
+
     struct ProcessingUnitConfig {
         bool reset_db = false;
         bool show_status = false;
         bool debug_mode = false;
+        bool run_benchmark = false;                          // --bench: quantization microbenchmark, then exit
+        size_t analysis_workers = 0;                         // --workers N (0 = one per spare core)
+        size_t queue_capacity = 64;                          // --queue-capacity N, per worker (rounded up to 2^k)
+        OverflowPolicy overflow_policy = OverflowPolicy::Spill; // --overflow block|spill|drop
+        size_t vector_dim = 256;                             // --dim N (multiple of 64, at most 4096)
+        Math::VectorCodec codec = Math::VectorCodec::SQ8;    // --codec sq8|sq4|binary|pq
+        size_t pq_subspaces = 0;                             // --pq-subspaces M (0 = dim / 8; must divide dim)
+        uint64_t feature_seed = DEFAULT_FEATURE_SEED;        // --hash-seed N (term -> bucket and sign)
+        bool idf_weighting = false;                          // --idf: scale terms by the live IDF
+        size_t word_ngrams = 1;                              // --ngrams N: add word n-grams of orders 2..N (at most 5)
+        size_t char_shingles = 0;                            // --shingles K: add character K-shingles (2..32, 0 = off)
+        std::string vocab_path = "vocab.idx";                // --vocab PATH: saved terms and IDF (ignored with --reset)
+        std::string codebook_path = "pq.codebook";           // --codebook PATH: trained PQ codebook (ignored with --reset)
+    };
+
+    // Ingest-side counters; owned by the scheduler thread (Ingest and Update)
+    struct IngestStats {
+        uint64_t accepted = 0;     // Documents that went straight into the queue
+        uint64_t spilled = 0;      // Documents parked in the ghost heap
+        uint64_t dropped = 0;      // Documents lost (Drop policy, or spill allocation failure)
+        uint64_t block_yields = 0; // Yields spent waiting for a slot (Block policy)
+        size_t spill_depth = 0;    // Documents currently parked
+        size_t spill_bytes = 0;
+    };
+
+    // --- IDF Manager (Inlined) ---
+    // Document frequencies indexed by shared TermID. One writer (the commit thread)
+    // counts; analysis workers read concurrently to weight vectors (--idf).
+    class IDFManager {
+    public:
+        // Writer: one call per committed document with its unique shared ids
+        void UpdateDocs(const std::vector<TermID>& unique_terms_in_doc) {
+            for (auto tid : unique_terms_in_doc) {
+                if (!m_term_doc_freqs.grow(static_cast<size_t>(tid) + 1)) continue;
+                auto& df = m_term_doc_freqs[tid];
+                df.store(df.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            m_total_docs.store(m_total_docs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        float GetIDF(TermID term_id, size_t total_docs) const {
+            if (total_docs == 0) return 0.0f;
+            const uint32_t df = GetDocFreq(term_id);
+            return std::log(static_cast<float>(total_docs) / (1.0f + df)) + 1.0f;
+        }
+
+        // Any thread
+        uint32_t GetDocFreq(TermID term_id) const {
+            return term_id < m_term_doc_freqs.size() ? m_term_doc_freqs[term_id].load(std::memory_order_relaxed) : 0;
+        }
+        uint64_t TotalDocs() const { return m_total_docs.load(std::memory_order_relaxed); }
+        size_t DocFreqCount() const { return m_term_doc_freqs.size(); }
+
+        // Writer, before any reader starts: freqs[id] is the document frequency of TermID id
+        void SetDocFreqs(std::span<const uint32_t> freqs, uint64_t total_docs) {
+            m_term_doc_freqs.grow(freqs.size());
+            for (size_t id = 0; id < freqs.size(); ++id) {
+                m_term_doc_freqs[id].store(freqs[id], std::memory_order_relaxed);
+            }
+            m_total_docs.store(total_docs, std::memory_order_relaxed);
+        }
+
+    private:
+        Core::SegmentedArray<std::atomic<uint32_t>> m_term_doc_freqs;
+        std::atomic<uint64_t> m_total_docs{0};
     };
 
     class ProcessingUnit {
@@ -26,47 +113,127 @@ namespace Hyperion {
         void Start();
         void Update(); 
         void Ingest(std::string_view text);
+
+        // Bulk load: deals the batch to the shards with one publish per shard; documents
+        // the queues cannot take go through the overflow policy, in order
+        void IngestBatch(std::span<const std::string_view> documents);
         void Shutdown();
         void RunBenchmark();
 
+        // Writes the document heap's counters, fragmentation and tag check to 'path'
+        void DumpHeapReport(const std::string& path);
+
+        const IngestStats& GetIngestStats() const { return m_ingest_stats; }
+        const ProcessingUnitConfig& GetConfig() const { return m_config; }
+
+        // Vector-log records are self-describing (dim, codec, size): see math/VectorCodec.hpp.
+        // A PQ collection stores its first PQ_TRAIN_DOCS documents as SQ8, trains the
+        // codebook on them, and encodes everything after that with it.
+        static constexpr size_t PQ_TRAIN_DOCS = 1024;
+
     private:
+        // One analysed document on its way from a shard to the committer
+        struct AnalysisResult {
+            bool has_record = false;                  // false: no terms survived, nothing to store
+            std::vector<char> record;                 // Exactly as in the vector log; the buffer stays with the slot
+            std::vector<TermID> terms;                // Unique shared vocabulary ids in the document
+        };
+
+        // One analysis worker. Documents are dealt round-robin, and each shard emits its
+        // results in arrival order, so reading the shards' outputs round-robin restores
+        // ingest order without a reorder buffer.
+        struct AnalysisShard {
+            AnalysisShard(size_t index, size_t capacity, ConcurrentVocabulary& vocabulary,
+                          Cognitron::Core::SlabMemoryResource* heap);
+
+            const size_t index;
+            uint64_t analysed = 0; // Worker-only: documents seen; with 'index' gives the ingest sequence
+
+            Core::LockFreeRingBuffer<std::string, Core::DYNAMIC_CAPACITY, Core::SpinFutexWait> input;
+            Core::LockFreeRingBuffer<AnalysisResult, Core::DYNAMIC_CAPACITY, Core::SpinFutexWait> output;
+
+            // Worker-only: tokenizer over the shared vocabulary, per-document arena
+            // (token table, token buffer, phrase hashes, dense vector; one Reset() per document)
+            Tokenizer tokenizer;
+            Cognitron::Core::BatchArena arena;
+
+            std::jthread thread;
+        };
+
         ProcessingUnitConfig m_config;
-        Tokenizer m_tokenizer;
+
+        // Vocabulary and document frequencies saved by the last run (--vocab), mapped read-only
+        std::unique_ptr<MappedVocabulary> m_saved_vocabulary;
+
+        // Shared by every shard: workers intern terms concurrently, and its hashes are the
+        // feature hashes (seeded with --hash-seed), so a term is hashed once per occurrence.
+        // Saved terms keep their ids; new ones are numbered after them.
+        ConcurrentVocabulary m_vocabulary{m_config.feature_seed, m_saved_vocabulary.get()};
+
+        // Document frequencies: written only by the commit thread
         IDFManager m_idf_manager;
         
         std::atomic<bool> m_running{false};
         int m_processing_cooldown = 0;
 
-        // Lock-Free Single-Producer Single-Consumer Ring Buffer for IPC
-        Core::LockFreeRingBuffer<std::string, 64> m_input_queue;
+        // Last vector-log window handed to MemoryManager::prefetch (commit thread only)
+        size_t m_prefetch_window = static_cast<size_t>(-1);
 
-        std::jthread m_analysis_thread;
+        // Ghost-backed heap for per-document scratch (see DOC_HEAP_OFFSET)
+        std::unique_ptr<Cognitron::Core::SlabAllocator> m_heap;
+        int m_heap_report_tick = 0;
 
-        void AnalysisWorker();
-        void ProcessDocument(const std::string& content);
-    };
+        // Shard arenas carve their chunks from m_heap once and then reuse them
+        std::unique_ptr<Cognitron::Core::SlabMemoryResource> m_heap_resource;
 
-    // --- IDF Manager (Inlined) ---
-    class IDFManager {
-    public:
-        void UpdateDocs(const std::vector<TermID>& unique_terms_in_doc) {
-             for (auto tid : unique_terms_in_doc) {
-                m_term_doc_freqs[tid]++;
-            }
-        }
-        
-        float GetIDF(TermID term_id, size_t total_docs) const {
-            if (total_docs == 0) return 0.0f;
-            auto it = m_term_doc_freqs.find(term_id);
-            uint32_t df = (it != m_term_doc_freqs.end()) ? it->second : 0;
-            return std::log(static_cast<float>(total_docs) / (1.0f + df)) + 1.0f;
-        }
+        // Each shard's input is a Lock-Free SPSC Ring Buffer fed by Ingest; workers sleep
+        // on a futex when it runs dry and are woken on empty -> non-empty.
+        std::vector<std::unique_ptr<AnalysisShard>> m_shards;
+        size_t m_next_shard = 0;   // Ingest side: shard for the next document
+        size_t m_commit_shard = 0; // Commit side: shard holding the oldest uncommitted document
 
-        const std::unordered_map<TermID, uint32_t>& GetDocFreqs() const { return m_term_doc_freqs; }
-        void SetDocFreqs(const std::unordered_map<TermID, uint32_t>& freqs) { m_term_doc_freqs = freqs; }
-        
-    private:
-        std::unordered_map<TermID, uint32_t> m_term_doc_freqs;
+        // Overflow spill (Spill policy): FIFO of m_heap records, linked by offset.
+        // Producer side only; dispatched to the shards ahead of new documents.
+        uint64_t m_spill_head = 0;
+        uint64_t m_spill_tail = 0;
+        IngestStats m_ingest_stats;
+
+        std::jthread m_commit_thread;
+
+        // PQ codebook: trained once by the commit thread (or loaded from --codebook), then
+        // published to the workers through m_pq_ready and never modified
+        std::unique_ptr<Math::ProductQuantizer> m_pq;
+        std::atomic<const Math::ProductQuantizer*> m_pq_ready{nullptr};
+        std::vector<float> m_pq_samples; // Commit thread: decoded training set
+        size_t m_pq_training_docs = 0;
+
+        void AnalysisWorker(AnalysisShard& shard);
+        void AnalyzeDocument(AnalysisShard& shard, const std::string& content, AnalysisResult& result);
+        void CommitWorker();
+        // Counts the result's terms and stages its record 'staged_bytes' past the log head;
+        // returns the record's size, 0 if the document produced no record
+        size_t CommitDocument(const AnalysisResult& result, size_t staged_bytes);
+        // Makes 'count' staged records ('bytes' long) visible: one head update, one release store
+        void PublishRecords(size_t count, size_t bytes);
+        // Encodes the dense vector into result.record with the collection's codec
+        void EncodeRecord(std::span<const float> dense_vec, uint64_t sequence, AnalysisResult& result);
+        // Adds a committed document to the PQ training set; trains once it is complete
+        void CollectTrainingSample(const AnalysisResult& result);
+        // Trains on the collected samples, publishes the codebook and saves it to --codebook
+        void TrainCodebook();
+        // Loads the codebook an earlier run saved to --codebook (same dim and subspaces)
+        void LoadCodebook();
+        // Writes the vocabulary and document frequencies to --vocab if they changed
+        void SaveVocabulary();
+
+        // Hands 'text' to the next shard in round-robin order; false if its queue is full
+        bool Dispatch(std::string_view text);
+        // Hands the longest in-order prefix that fits to the shards; returns its length.
+        // 'documents' must not contain empty texts (IngestBatch splits the batch at them).
+        size_t DispatchBatch(std::span<const std::string_view> documents);
+        void Overflow(std::string_view text);
+        bool SpillDocument(std::string_view text);
+        void DrainSpill();
     };
 
 } // namespace Hyperion
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <memory>
+
+namespace Hyperion::Core {
+
+    /**
+     * @brief Growable array with stable element addresses and lock-free reads.
+     *
+     * Elements live in fixed-size segments that are allocated on demand and never
+     * moved, so a reader can index while the single writer appends. The writer fills
+     * an element, then publishes the new size with a release store; a reader that
+     * sees size() > i (acquire) also sees element i.
+     *
+     * Thread Safety: push_back / grow from ONE writer thread; size / operator[] from any.
+     */
+    template<typename T, size_t SegmentBits = 16, size_t MaxSegments = 4096>
+    class SegmentedArray {
+    public:
+        static constexpr size_t SEGMENT_SIZE = size_t{1} << SegmentBits;
+        static constexpr size_t MAX_SIZE = SEGMENT_SIZE * MaxSegments;
+
+        SegmentedArray() = default;
+        ~SegmentedArray() {
+            for (auto& segment : m_segments) delete[] segment.load(std::memory_order_relaxed);
+        }
+
+        SegmentedArray(const SegmentedArray&) = delete;
+        SegmentedArray& operator=(const SegmentedArray&) = delete;
+
+        size_t size() const { return m_size.load(std::memory_order_acquire); }
+
+        // Index must be below a size() this thread has observed (or be the writer's own)
+        T& operator[](size_t index) {
+            return m_segments[index >> SegmentBits].load(std::memory_order_relaxed)[index & (SEGMENT_SIZE - 1)];
+        }
+        const T& operator[](size_t index) const {
+            return m_segments[index >> SegmentBits].load(std::memory_order_relaxed)[index & (SEGMENT_SIZE - 1)];
+        }
+
+        // Writer: appends and publishes. False once MAX_SIZE is reached.
+        bool push_back(const T& value) {
+            const size_t index = m_size.load(std::memory_order_relaxed);
+            if (!Reserve(index + 1)) return false;
+            (*this)[index] = value;
+            m_size.store(index + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Writer: extends to 'count' value-initialised elements (no-op if already larger)
+        bool grow(size_t count) {
+            if (count <= m_size.load(std::memory_order_relaxed)) return true;
+            if (!Reserve(count)) return false;
+            m_size.store(count, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        bool Reserve(size_t count) {
+            if (count > MAX_SIZE) return false;
+            for (size_t segment = 0; segment * SEGMENT_SIZE < count; ++segment) {
+                if (!m_segments[segment].load(std::memory_order_relaxed)) {
+                    // Value-initialised, so atomics and counters start at zero
+                    m_segments[segment].store(new T[SEGMENT_SIZE](), std::memory_order_release);
+                }
+            }
+            return true;
+        }
+
+        std::array<std::atomic<T*>, MaxSegments> m_segments{};
+        std::atomic<size_t> m_size{0};
+    };
+
+}
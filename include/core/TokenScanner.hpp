@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <memory_resource>
+
+namespace Hyperion {
+
+    /**
+     * @brief Splits UTF-8 text into case-folded word tokens, 64 bytes at a time.
+     *
+     * Each 64-byte block is classified with SIMD compares (AVX2 picked at runtime,
+     * SSE2 / NEON otherwise) into a word-byte bitmask (ASCII alphanumerics and all
+     * bytes >= 0x80) plus a lowercased copy of the block. Run boundaries are then
+     * found with bit scans, so the per-byte work is a handful of vector
+     * instructions and the per-token work a couple of tzcnts, with no per-token
+     * case branch.
+     *
+     * Tokens are string_views into the input when their block has no uppercase
+     * letter, otherwise into that block's lowercased copy (or, for a mixed-case
+     * token straddling blocks, a copy owned by the scanner). Either way a token is
+     * valid until the next call to Next().
+     *
+     * Pure-ASCII runs take that path. A run containing bytes >= 0x80 is decoded
+     * instead (see core/Unicode.hpp): letters, digits
+     * and marks of any script form words, punctuation, symbols and emoji separate
+     * them, each Han / Hiragana character is a token of its own, and code points
+     * are case-folded. Those tokens always live in the scanner's own buffer.
+     * ASCII-only text tokenizes exactly as [0-9A-Za-z]+, lowercased.
+     */
+    class TokenScanner {
+    public:
+        static constexpr size_t BLOCK = 64;
+
+        TokenScanner(std::string_view text, std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+        // Next token, lowercased; false once the text is exhausted
+        bool Next(std::string_view& token);
+
+        // Name of the block classifier in use ("avx2", "sse2", "neon", "scalar")
+        static const char* KernelName();
+
+    private:
+        // Classifies the block at 'offset' (zero-padded past the end); false past the end
+        bool LoadBlock(size_t offset);
+        // Next token of the pending non-ASCII run; false once the run is used up
+        bool NextInRun(std::string_view& token);
+
+        std::string_view m_text;
+        size_t m_block = 0;     // Offset of the current block
+        size_t m_bit = BLOCK;   // Scan position within it (BLOCK: block consumed)
+        uint64_t m_word = 0;    // Bit i: byte m_block + i is a word byte
+        uint64_t m_high = 0;    // Bit i: byte m_block + i is >= 0x80
+        size_t m_run_pos = 0;   // Pending non-ASCII run [m_run_pos, m_run_end)
+        size_t m_run_end = 0;
+        const char* m_source = nullptr; // Current block as lowercase: the input itself, or m_lowered_block
+        alignas(64) char m_lowered_block[BLOCK] = {}; // Current block, lowercased by the classifier
+        std::pmr::string m_lowered; // Tokens from the slow path, and lowercased tokens straddling blocks
+    };
+
+} // namespace Hyperion
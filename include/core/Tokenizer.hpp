@@ -4,29 +4,56 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
-#include <unordered_set>
+#include <memory_resource>
 #include <cstdint>
 
+#include "core/NGram.hpp"
+#include "core/Vocabulary.hpp"
+
 namespace Hyperion {
 
-    using TermID = uint32_t;
+    // Term -> occurrence count for one document. Allocates from the caller's resource,
+    // so a per-document arena makes tokenization heap-free.
+    using TermCounts = std::pmr::unordered_map<TermID, int>;
+
+    // Feature hashes of a document's word n-grams and character shingles, one per
+    // occurrence, in text order. Same allocation rules as TermCounts.
+    using PhraseHashes = std::pmr::vector<uint64_t>;
 
     class Tokenizer {
     public:
+        // Private vocabulary (single thread)
         Tokenizer();
-        std::unordered_map<TermID, int> Tokenize(std::string_view text);
-        TermID GetTermID(std::string_view token);
+        // Interns into 'shared', which many tokenizers on different threads may use at once
+        explicit Tokenizer(ConcurrentVocabulary& shared);
+        // Counts the lowercase alphanumeric tokens of 'text' (see TokenScanner), minus stopwords.
+        // With 'phrases' and SetPhraseFeatures, also appends the document's phrase features.
+        TermCounts Tokenize(std::string_view text,
+                            std::pmr::memory_resource* scratch = std::pmr::get_default_resource(),
+                            PhraseHashes* phrases = nullptr);
+        // Word n-grams of orders 2..ngrams over the non-stopword terms (ngrams <= 1: none) and
+        // character shingles of 'shingle' bytes over the normalized text, stopwords included
+        // (0: none). Term hashes come from the shared vocabulary, or HashTerm(term, seed).
+        void SetPhraseFeatures(size_t ngrams, size_t shingle, uint64_t seed);
+        bool HasPhraseFeatures() const { return m_ngrams.Enabled() || m_shingles.Enabled(); }
+        TermID GetTermID(std::string_view token) { return m_shared ? m_shared->Intern(token) : m_vocab.Intern(token); }
+        // View into the vocabulary's arena; a private vocabulary's views last until its next new term
+        std::string_view GetTerm(TermID id) const { return m_shared ? m_shared->Term(id) : m_vocab.Term(id); }
         std::string GetTermString(TermID id) const;
-        bool IsStopWord(std::string_view token) const;
-        size_t VocabularySize() const { return m_vocab.size(); }
-        const std::unordered_map<std::string, TermID>& GetVocab() const { return m_vocab; }
-        const std::vector<std::string>& GetInverseVocab() const { return m_inverse_vocab; }
-        void SetVocab(const std::vector<std::string>& inverse_vocab); 
+        bool IsStopWord(std::string_view token) const { return m_stopwords.contains(token); }
+        size_t VocabularySize() const { return m_shared ? m_shared->size() : m_vocab.size(); }
     private:
-        std::unordered_set<std::string> m_stopwords;
-        std::unordered_map<std::string, TermID> m_vocab;
-        std::vector<std::string> m_inverse_vocab;
-        TermID m_next_term_id = 1; 
+        void TokenizePhrases(std::string_view text, std::pmr::memory_resource* scratch,
+                             TermCounts& counts, PhraseHashes& phrases);
+
+        StopwordSet m_stopwords;
+        Vocabulary m_vocab;
+        ConcurrentVocabulary* m_shared = nullptr;
+
+        // Rolling state, restarted by every Tokenize
+        WordNGrams m_ngrams;
+        CharShingles m_shingles;
+        uint64_t m_phrase_seed = DEFAULT_FEATURE_SEED;
     };
 
 } // namespace Hyperion
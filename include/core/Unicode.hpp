@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <memory_resource>
+
+namespace Hyperion::Unicode {
+
+    // Substituted for every malformed UTF-8 sequence
+    static constexpr char32_t REPLACEMENT = 0xFFFD;
+
+    /**
+     * @brief Decodes one code point from 'p' (at most 'size' bytes, size > 0).
+     *
+     * Strict: overlong forms, surrogates, values past U+10FFFF and truncated or
+     * stray continuation bytes all yield REPLACEMENT with a length of 1, so the
+     * caller resynchronises on the next byte.
+     */
+    char32_t Decode(const char* p, size_t size, size_t& length);
+
+    // Appends 'cp' as UTF-8
+    void Append(std::pmr::string& out, char32_t cp);
+
+    // How a code point takes part in tokenization (a coarse cut of UAX #29 word breaks)
+    enum class WordClass : uint8_t {
+        Separator, // Spaces, punctuation, symbols, emoji, controls, private use, malformed input
+        Word,      // Letters, digits and combining marks of alphabetic scripts: runs form one token
+        Ideograph  // Han and Hiragana: written without spaces, so each is a token of its own
+    };
+
+    WordClass Classify(char32_t cp);
+
+    /**
+     * @brief Simple (1:1) case folding, plus fullwidth ASCII to ASCII.
+     *
+     * Covers Latin-1, Latin Extended-A/B (the common pairs), Latin Extended
+     * Additional, Greek (including final sigma), Cyrillic, Armenian and the
+     * fullwidth forms. Folds that change length (ß -> ss) are left alone, as in
+     * CaseFolding.txt status 'S'.
+     */
+    char32_t Fold(char32_t cp);
+
+} // namespace Hyperion::Unicode
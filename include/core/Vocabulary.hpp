@@ -0,0 +1,225 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace Hyperion {
+
+    using TermID = uint32_t;
+
+    class MappedVocabulary;
+
+    /**
+     * @brief String-interning term table: open addressing over a contiguous string arena.
+     *
+     * Every term's bytes are appended once to a single character arena; 'offsets'
+     * maps a TermID to its slice, so TermIDs are dense (1..size) and Term(id) is a
+     * view with no per-term allocation. The index is a power-of-two array of
+     * {hash tag, id} slots probed linearly: a lookup hashes the string_view once,
+     * compares 32-bit tags and only then the bytes. Looking up a known term
+     * allocates nothing; interning a new one appends to the arena (amortised).
+     *
+     * Thread Safety: none; one owner thread.
+     */
+    class Vocabulary {
+    public:
+        Vocabulary();
+
+        // Id of 'term', or 0 if it has not been interned
+        TermID Find(std::string_view term) const;
+
+        // Id of 'term', interning it with the next free id if new
+        TermID Intern(std::string_view term);
+
+        // Interns 'term' under a caller-chosen id (rebuilding a saved vocabulary); false if taken
+        bool InternAs(std::string_view term, TermID id);
+
+        // Text of 'id'; empty for 0 and for ids never assigned
+        std::string_view Term(TermID id) const {
+            if (id + size_t{1} >= m_offsets.size()) return {};
+            return std::string_view(m_chars.data() + m_offsets[id], m_offsets[id + 1] - m_offsets[id]);
+        }
+
+        // Interned terms (ids assigned in order have no gaps, so this is also the largest id)
+        size_t size() const { return m_count; }
+
+        // Next id Intern() will hand out
+        TermID NextID() const { return static_cast<TermID>(m_offsets.size() - 1); }
+
+        void clear();
+
+    private:
+        struct Slot {
+            uint32_t tag; // High half of the term's hash
+            TermID id;    // 0: empty
+        };
+
+        static uint32_t Tag(std::string_view term);
+        size_t Probe(std::string_view term, uint32_t tag) const; // Slot holding 'term', or the empty slot ending its run
+        void Insert(uint32_t tag, TermID id);
+        void Grow();
+
+        std::vector<char> m_chars;       // All term bytes, back to back
+        std::vector<uint32_t> m_offsets; // Term(id) = m_chars[offsets[id], offsets[id + 1])
+        std::vector<Slot> m_slots;
+        size_t m_count = 0;
+    };
+
+    /**
+     * @brief Fixed stopword set behind a collision-free multiplicative hash.
+     *
+     * Stopwords are short, so each is packed into a 64-bit key (its bytes, zero
+     * padded; tokens never contain NUL). The constructor searches for a multiplier
+     * that sends every key to its own bit of a 128-bit table; a query is then one
+     * load, one multiply, one bit test and one key compare. Tokens longer than
+     * eight bytes are rejected on length alone.
+     */
+    class StopwordSet {
+    public:
+        // Throws std::invalid_argument for a word longer than eight bytes or a set too large to place
+        explicit StopwordSet(const std::vector<std::string_view>& words);
+
+        bool contains(std::string_view token) const {
+            if (token.size() > MAX_LENGTH || token.empty()) return false;
+            const uint64_t key = Pack(token);
+            const size_t index = Index(key);
+            return ((m_bits[index >> 6] >> (index & 63)) & 1) != 0 && m_keys[index] == key;
+        }
+
+    private:
+        static constexpr size_t MAX_LENGTH = 8;
+        static constexpr size_t TABLE_BITS = 7;
+
+        static uint64_t Pack(std::string_view token) {
+            uint64_t key = 0;
+            std::memcpy(&key, token.data(), token.size());
+            return key;
+        }
+        size_t Index(uint64_t key) const { return static_cast<size_t>((key * m_multiplier) >> (64 - TABLE_BITS)); }
+
+        uint64_t m_multiplier = 0;
+        uint64_t m_bits[(size_t{1} << TABLE_BITS) / 64] = {};
+        uint64_t m_keys[size_t{1} << TABLE_BITS] = {};
+    };
+
+    /**
+     * @brief Term dictionary shared by many tokenizer threads: lock-free reads, sharded inserts.
+     *
+     * Terms are split over SHARDS by the top bits of their hash. Each shard has a
+     * linear-probing table of packed {tag, id} words and its own character arena.
+     * Lookups never lock: they load the shard's current table (acquire) and probe
+     * it. Inserting takes only the term's shard lock, so threads adding different
+     * terms rarely meet. A full table is doubled under that lock and swapped in; the
+     * old one stays alive (readers may still be probing it) until destruction, which
+     * costs at most as much again as the live tables.
+     *
+     * Ids come from one atomic counter, so they are dense and stable: a term keeps
+     * the id of whichever thread interned it first. Each id's entry (text, hash) is
+     * written before the id is published into a table, so any id a reader obtains
+     * is fully readable. size() only counts the prefix of ids whose entries are all
+     * published, so ids 1..size() can always be walked, even mid-insert.
+     *
+     * The stored 64-bit hash is HashTerm(term, seed), so callers hashing terms with
+     * the same seed for other purposes (feature slots) can reuse it via Hash(id).
+     *
+     * A saved vocabulary (MappedVocabulary, same seed) can be layered underneath: its
+     * ids 1..base.size() are served straight from the mapping, looked up before the
+     * shards, and new terms continue from base.size() + 1.
+     */
+    class ConcurrentVocabulary {
+    public:
+        static constexpr size_t SHARD_BITS = 6;
+        static constexpr size_t SHARDS = size_t{1} << SHARD_BITS;
+        static constexpr size_t MAX_TERMS = (size_t{1} << 26) - 1;
+
+        // 'base', if any, must outlive the vocabulary; throws std::invalid_argument if
+        // it was saved with a different seed (its hashes would not match)
+        explicit ConcurrentVocabulary(uint64_t seed, const MappedVocabulary* base = nullptr);
+        ~ConcurrentVocabulary();
+
+        ConcurrentVocabulary(const ConcurrentVocabulary&) = delete;
+        ConcurrentVocabulary& operator=(const ConcurrentVocabulary&) = delete;
+
+        // Any thread, lock-free: id of 'term', or 0 if not interned (yet)
+        TermID Find(std::string_view term) const;
+
+        // Any thread: id of 'term', interning it if new (locks one shard, only for new terms).
+        // Returns 0 once MAX_TERMS ids have been handed out.
+        TermID Intern(std::string_view term);
+
+        // Any thread, for an id returned by Find / Intern or at most size()
+        std::string_view Term(TermID id) const {
+            if (id - 1 < m_base_size) return BaseTerm(id);
+            const Entry& entry = GetEntry(id);
+            return std::string_view(entry.data, entry.length);
+        }
+        uint64_t Hash(TermID id) const {
+            if (id - 1 < m_base_size) return BaseHash(id);
+            return GetEntry(id).hash;
+        }
+
+        // Ids 1..size() are all published
+        size_t size() const { return m_size.load(std::memory_order_acquire); }
+        uint64_t Seed() const { return m_seed; }
+
+    private:
+        // Id -> entry directory: segments allocated on first use and never moved
+        static constexpr size_t SEGMENT_BITS = 12;
+        static constexpr size_t SEGMENT_SIZE = size_t{1} << SEGMENT_BITS;
+        static constexpr size_t MAX_SEGMENTS = (MAX_TERMS + 1) / SEGMENT_SIZE;
+        static constexpr size_t ARENA_CHUNK = 64 * 1024;
+
+        struct Entry {
+            const char* data;
+            uint32_t length;
+            std::atomic<bool> ready; // Entry written; drives size()
+            uint64_t hash;
+        };
+
+        struct Table {
+            explicit Table(size_t capacity);
+            size_t mask;
+            std::unique_ptr<std::atomic<uint64_t>[]> slots; // (tag << 32) | id; 0 = empty
+        };
+
+        struct alignas(64) Shard {
+            std::mutex lock;
+            std::atomic<Table*> table{nullptr};
+            size_t count = 0;                          // Under lock
+            std::vector<std::unique_ptr<Table>> tables; // Current and retired, under lock
+            std::vector<std::unique_ptr<char[]>> chunks;
+            char* cursor = nullptr;
+            size_t left = 0;
+        };
+
+        static Shard& ShardOf(Shard* shards, uint64_t hash) { return shards[hash >> (64 - SHARD_BITS)]; }
+        static uint64_t Pack(uint64_t hash, TermID id) { return ((hash >> 32) << 32) | id; }
+
+        const Entry& GetEntry(TermID id) const {
+            return m_segments[id >> SEGMENT_BITS].load(std::memory_order_acquire)[id & (SEGMENT_SIZE - 1)];
+        }
+
+        TermID Probe(const Table& table, std::string_view term, uint64_t hash) const;
+        Entry& EntryFor(TermID id); // Allocates the segment on first use
+        const char* Store(Shard& shard, std::string_view term);
+        void Grow(Shard& shard);
+        void AdvanceSize();
+        std::string_view BaseTerm(TermID id) const;
+        uint64_t BaseHash(TermID id) const;
+
+        const uint64_t m_seed;
+        const MappedVocabulary* m_base;
+        const size_t m_base_size; // Ids 1..m_base_size live in m_base
+        std::unique_ptr<Shard[]> m_shards;
+        std::unique_ptr<std::atomic<Entry*>[]> m_segments;
+        alignas(64) std::atomic<uint32_t> m_next_id{1};
+        alignas(64) std::atomic<size_t> m_size{0};
+    };
+
+} // namespace Hyperion
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/Vocabulary.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Hyperion {
+
+    /**
+     * @brief Read-only term dictionary and document frequencies, memory-mapped from disk.
+     *
+     * One file holds a saved ConcurrentVocabulary (ids 1..size()) and the IDF counts
+     * that go with it, laid out so it can be used in place:
+     *
+     *   header | blob | offsets | ranks | hashes | doc_freqs | index
+     *
+     *   blob       every term's bytes, in sorted order
+     *   offsets    uint64[size + 1]: term of rank r is blob[offsets[r], offsets[r + 1])
+     *   ranks      uint32[size + 1]: TermID -> rank (entry 0 unused)
+     *   hashes     uint64[size + 1]: HashTerm(term, seed) by TermID
+     *   doc_freqs  uint32[size + 1]: document frequency by TermID
+     *   index      uint64[2^k]: linear-probing table of (tag << 32) | id, 0 = empty
+     *
+     * Sections are 8-byte aligned and in native byte order. Open() validates the header
+     * and section bounds and maps the file; nothing is rebuilt, so it costs the same for
+     * ten terms as for ten million and pages fault in as lookups touch them. Entries are
+     * bounds-checked as they are read instead, so a damaged file yields wrong or empty
+     * terms but never an out-of-bounds read or an endless probe.
+     */
+    class MappedVocabulary {
+    public:
+        ~MappedVocabulary();
+
+        MappedVocabulary(const MappedVocabulary&) = delete;
+        MappedVocabulary& operator=(const MappedVocabulary&) = delete;
+
+        // nullptr if 'path' is missing or not a valid vocabulary file (reported on stderr)
+        static std::unique_ptr<MappedVocabulary> Open(const std::string& path);
+
+        // Writes ids 1..vocabulary.size() and doc_freqs (indexed by TermID, missing
+        // entries count as 0) to 'path' through a temporary file and a rename, so a
+        // mapping of the previous file stays valid. False on I/O failure.
+        static bool Write(const std::string& path, const ConcurrentVocabulary& vocabulary,
+                          std::span<const uint32_t> doc_freqs, uint64_t total_docs);
+
+        // Id of 'term' (hash = HashTerm(term, Seed())), or 0 if it is not in the file
+        TermID Find(std::string_view term, uint64_t hash) const;
+
+        // For ids 1..size(); empty if the file's entry for 'id' is out of range
+        std::string_view Term(TermID id) const {
+            const uint32_t rank = m_ranks[id];
+            if (rank >= m_size) return {};
+            const uint64_t begin = m_offsets[rank], end = m_offsets[rank + 1];
+            if (begin > end || end > m_blob_bytes) return {};
+            return std::string_view(m_blob + begin, end - begin);
+        }
+        uint64_t Hash(TermID id) const { return m_hashes[id]; }
+
+        // Indexed by TermID, size() + 1 entries
+        std::span<const uint32_t> DocFreqs() const { return {m_doc_freqs, m_size + 1}; }
+        uint64_t TotalDocs() const { return m_total_docs; }
+
+        size_t size() const { return m_size; }
+        uint64_t Seed() const { return m_seed; }
+
+    private:
+        MappedVocabulary() = default;
+
+        void* m_map = nullptr;
+        size_t m_map_bytes = 0;
+
+        size_t m_size = 0;
+        uint64_t m_seed = 0;
+        uint64_t m_total_docs = 0;
+        size_t m_index_mask = 0;
+        const char* m_blob = nullptr;
+        uint64_t m_blob_bytes = 0;
+        const uint64_t* m_offsets = nullptr;
+        const uint32_t* m_ranks = nullptr;
+        const uint64_t* m_hashes = nullptr;
+        const uint32_t* m_doc_freqs = nullptr;
+        const uint64_t* m_index = nullptr;
+    };
+
+} // namespace Hyperion
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <thread>
+
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+#include "core/CpuRelax.hpp"
+#include "kernel/Scheduler.hpp"
+
+namespace Hyperion::Core {
+
+    /**
+     * @brief Consumer-side wait policies for the lock-free queues.
+     *
+     * A strategy provides:
+     *   Wait(ready)  - consumer: return once ready() holds (spurious returns allowed)
+     *   Notify()     - producer: the queue went from empty to non-empty
+     *   Wake()       - anyone: force waiters out (shutdown); they re-check ready()
+     *
+     * The queue calls Notify() only when a publish finds the consumer caught up, so
+     * a busy pipeline never touches the strategy. Lost wake-ups are ruled out by a
+     * Dekker handshake: the consumer registers as a waiter and fences before its
+     * final ready() check, and the producer fences after publishing before it looks
+     * for waiters.
+     */
+    template<typename W>
+    concept WaitStrategy = requires(W w, bool (*ready)()) {
+        { W::NOTIFIES } -> std::convertible_to<bool>;
+        w.Wait(ready);
+        w.Notify();
+        w.Wake();
+    };
+
+    // Pauses before a waiter gives up the CPU: ~a few microseconds, about one syscall round trip
+    static constexpr int WAIT_SPIN_LIMIT = 2048;
+
+    /**
+     * @brief Plain polling: Wait() yields the thread once. Producers pay nothing.
+     * Default for LockFreeRingBuffer, which keeps its original cost model.
+     */
+    struct PollWait {
+        static constexpr bool NOTIFIES = false;
+
+        template<typename Ready>
+        void Wait(Ready&& ready) {
+            if (!ready()) std::this_thread::yield();
+        }
+        void Notify() {}
+        void Wake() {}
+    };
+
+    /**
+     * @brief Spin, then sleep in the kernel on a 32-bit epoch word.
+     *
+     * std::atomic<uint32_t>::wait/notify is a futex on Linux (ulock on macOS), so
+     * a sleeping consumer costs no CPU and is woken in a few microseconds. The
+     * producer skips the syscall entirely unless a consumer is actually asleep.
+     */
+    class SpinFutexWait {
+    public:
+        static constexpr bool NOTIFIES = true;
+
+        template<typename Ready>
+        void Wait(Ready&& ready) {
+            for (int i = 0; i < WAIT_SPIN_LIMIT; ++i) {
+                if (ready()) return;
+                CpuRelax();
+            }
+
+            // Epoch is read before registering, so a Notify() after this point changes it
+            const uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+            m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready()) {
+                m_epoch.wait(epoch, std::memory_order_acquire);
+            }
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void Notify() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_sleepers.load(std::memory_order_relaxed) == 0) return;
+            m_epoch.fetch_add(1, std::memory_order_release);
+            m_epoch.notify_one();
+        }
+
+        void Wake() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_epoch.fetch_add(1, std::memory_order_release);
+            m_epoch.notify_all();
+        }
+
+    private:
+        alignas(64) std::atomic<uint32_t> m_epoch{0};
+        std::atomic<uint32_t> m_sleepers{0};
+    };
+
+    /**
+     * @brief Readiness signalled through a file descriptor, for reactor integration.
+     *
+     * Every Notify() makes NativeHandle() readable (eventfd on Linux, a non-blocking
+     * pipe elsewhere), so the queue can sit in an epoll/kqueue set next to sockets.
+     * Wait() spins, then poll()s the descriptor itself and drains it.
+     */
+    class EventFdWait {
+    public:
+        static constexpr bool NOTIFIES = true;
+
+        EventFdWait() {
+#if defined(__linux__)
+            m_read_fd = m_write_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+            int fds[2] = {-1, -1};
+            if (::pipe(fds) == 0) {
+                for (int fd : fds) {
+                    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+                    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+                }
+            }
+            m_read_fd = fds[0];
+            m_write_fd = fds[1];
+#endif
+        }
+
+        ~EventFdWait() {
+            if (m_read_fd >= 0) ::close(m_read_fd);
+            if (m_write_fd >= 0 && m_write_fd != m_read_fd) ::close(m_write_fd);
+        }
+
+        EventFdWait(const EventFdWait&) = delete;
+        EventFdWait& operator=(const EventFdWait&) = delete;
+
+        // Register for POLLIN; call Drain() once readable, then consume the queue
+        int NativeHandle() const { return m_read_fd; }
+
+        template<typename Ready>
+        void Wait(Ready&& ready) {
+            for (int i = 0; i < WAIT_SPIN_LIMIT; ++i) {
+                if (ready()) return;
+                CpuRelax();
+            }
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready()) {
+                pollfd pfd{m_read_fd, POLLIN, 0};
+                ::poll(&pfd, 1, -1);
+            }
+            Drain();
+        }
+
+        void Notify() { Signal(); }
+        void Wake() { Signal(); }
+
+        void Drain() {
+            uint64_t buf[8];
+            while (::read(m_read_fd, buf, sizeof(buf)) > 0) {}
+        }
+
+    private:
+        void Signal() {
+            const uint64_t one = 1;
+            // EAGAIN means the counter / pipe is already signalled; nothing is lost
+            [[maybe_unused]] auto written = ::write(m_write_fd, &one, sizeof(one));
+        }
+
+        int m_read_fd = -1;
+        int m_write_fd = -1;
+    };
+
+    /**
+     * @brief Parks the consuming fiber in Kernel::Scheduler instead of blocking its thread.
+     *
+     * The waiting fiber drops out of the round robin until a producer (fiber or
+     * OS thread) unparks it, so the host thread keeps running the other fibers.
+     * Wait() must be called from a fiber on the scheduler thread; there is no
+     * spin phase, since spinning would stall every fiber on the host.
+     */
+    class FiberParkWait {
+    public:
+        static constexpr bool NOTIFIES = true;
+
+        template<typename Ready>
+        void Wait(Ready&& ready) {
+            auto& sched = Kernel::Scheduler::Get();
+            Kernel::Fiber* self = sched.Current();
+            const uint32_t wakes = m_wakes.load(std::memory_order_acquire);
+
+            m_waiter.store(self, std::memory_order_seq_cst);
+            // Park() also returns when no other fiber is runnable, so re-check until
+            // ready (or woken); the flag is cleared on the way out either way, or
+            // Yield() would skip this fiber for good
+            for (;;) {
+                sched.PrepareToPark();
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (ready() || m_wakes.load(std::memory_order_acquire) != wakes) break;
+                sched.Park();
+            }
+            Kernel::Scheduler::Unpark(self);
+            m_waiter.store(nullptr, std::memory_order_relaxed);
+        }
+
+        void Notify() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (Kernel::Fiber* waiter = m_waiter.load(std::memory_order_acquire)) {
+                Kernel::Scheduler::Unpark(waiter);
+            }
+        }
+
+        void Wake() {
+            m_wakes.fetch_add(1, std::memory_order_release);
+            Notify();
+        }
+
+    private:
+        std::atomic<Kernel::Fiber*> m_waiter{nullptr};
+        std::atomic<uint32_t> m_wakes{0};
+    };
+
+}
@@ -4,6 +4,8 @@
 #include <vector>
 #include <functional>
 #include <string>
+#include <thread>
+#include <atomic>
 #include <unistd.h> // size_t
 
 extern "C" {
@@ -20,6 +22,7 @@ struct Fiber {
     size_t stack_size;
     std::string name;
     bool is_completed;
+    std::atomic<bool> parked{false}; // Skipped by Yield() until Unpark()
 
     Fiber(uint64_t id, std::string name, size_t stack_size);
     ~Fiber();
@@ -34,7 +37,17 @@ public:
     void Yield();
     void Run();
 
+    // Parking: PrepareToPark() flags the current fiber, the caller re-checks its wake
+    // condition, then Park() yields until another fiber or thread calls Unpark().
+    // Park() may return spuriously (e.g. no other fiber runnable); callers loop.
+    void PrepareToPark() { current_fiber->parked.store(true, std::memory_order_seq_cst); }
+    void Park();
+    static void Unpark(Fiber* fiber) { fiber->parked.store(false, std::memory_order_release); }
+
     Fiber* Current() { return current_fiber; }
+
+    // Fibers only run on the thread that called Init(); Yield() from any other thread is invalid
+    bool IsSchedulerThread() const { return std::this_thread::get_id() == owner_thread; }
     const std::vector<Fiber*>& AllFibers() { return fibers; }
 
 private:
@@ -46,6 +59,7 @@ private:
     Fiber* current_fiber = nullptr;
     Fiber* main_fiber = nullptr; // The OS thread we started on
     size_t current_idx = 0;
+    std::thread::id owner_thread;
 };
 
 } // namespace Kernel
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Hyperion::Math {
+
+    // Dot product of two int8 vectors (NEON when available, scalar otherwise)
+    int32_t SIMD_Dot_Int8(const int8_t* a, const int8_t* b, size_t count);
+
+    // Per-vector scalar quantization parameters. Decoding, by codec:
+    //   SQ8:    value = (code + 128) * scale + bias
+    //   SQ4:    value = code * scale + bias
+    //   Binary: value = bias + (bit ? scale : -scale)
+    struct QuantParams {
+        float scale;
+        float bias;
+    };
+
+    // Codes per product-quantization subspace (one byte per subspace)
+    static constexpr size_t PQ_CENTROIDS = 256;
+
+    // Smallest and largest element of a non-empty array
+    void MinMax(const float* data, size_t count, float& min_out, float& max_out);
+
+    /**
+     * @brief Min/max scalar quantization of 'src' into signed 8-bit codes.
+     *
+     * code = nearbyint((v - min) * (255 / (max - min))) - 128, saturated to int8.
+     * One reciprocal per vector, no divides or std::round in the loop. A flat vector
+     * (max == min) encodes as all -128 with scale 1, so it decodes back to 'min'.
+     * Every kernel rounds to nearest-even, so all paths produce identical codes.
+     *
+     * Dispatches to AVX-512 / AVX2 (chosen once from CPUID) or NEON, else scalar.
+     */
+    QuantParams QuantizeSQ8(const float* src, int8_t* dst, size_t count);
+
+    // Portable reference kernel (what QuantizeSQ8 falls back to)
+    QuantParams QuantizeSQ8Scalar(const float* src, int8_t* dst, size_t count);
+
+    // Min/max 4-bit quantization, two codes per byte (even index in the low nibble)
+    QuantParams QuantizeSQ4(const float* src, uint8_t* dst, size_t count);
+
+    // One bit per element (LSB first): set when the element is above the vector's mean
+    QuantParams QuantizeBinary(const float* src, uint8_t* dst, size_t count);
+
+    // Name of the kernel QuantizeSQ8 dispatches to ("avx512", "avx2", "neon", "scalar")
+    const char* QuantizeKernelName();
+
+    // --- Distance Kernels ---
+    // Asymmetric: a float query against an encoded vector, decoded on the fly.
+
+    // Squared L2 between two float vectors
+    float L2Sqr(const float* a, const float* b, size_t count);
+
+    float L2SqrSQ8(const float* query, const int8_t* codes, QuantParams params, size_t count);
+    float L2SqrSQ4(const float* query, const uint8_t* codes, QuantParams params, size_t count);
+
+    // Differing bits between two binary codes
+    uint32_t HammingDistance(const uint8_t* a, const uint8_t* b, size_t bytes);
+
+    // Sum of table[m * PQ_CENTROIDS + codes[m]] over the subspaces (see ProductQuantizer)
+    float PQDistance(const float* table, const uint8_t* codes, size_t subspaces);
+
+} // namespace Hyperion::Math
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "math/Math.hpp"
+
+namespace Hyperion::Math {
+
+    /**
+     * @brief Product quantizer: 'subspaces' independent k-means codebooks of
+     * PQ_CENTROIDS centroids, one byte of code per subspace.
+     *
+     * A vector is split into equal sub-vectors (dim must be a multiple of subspaces)
+     * and each is replaced by its nearest centroid's index. Distances use ADC: build
+     * the query's table once with ComputeDistanceTable, then PQDistance() costs one
+     * lookup per subspace per encoded vector.
+     *
+     * Immutable after Train, so any number of threads may Encode concurrently.
+     */
+    class ProductQuantizer {
+    public:
+        ProductQuantizer(size_t dim, size_t subspaces);
+
+        // Restores a trained codebook (as returned by Codebook())
+        ProductQuantizer(size_t dim, size_t subspaces, std::span<const float> codebook);
+
+        // Lloyd's k-means per subspace over 'count' row-major vectors of Dim() floats
+        void Train(const float* samples, size_t count, size_t iterations = 8);
+
+        void Encode(const float* vec, uint8_t* codes) const;
+        void Decode(const uint8_t* codes, float* out) const;
+
+        // table[m * PQ_CENTROIDS + c] = squared distance from the query's sub-vector m to centroid c
+        void ComputeDistanceTable(const float* query, float* table) const;
+
+        size_t Dim() const { return m_dim; }
+        size_t Subspaces() const { return m_subspaces; }
+        size_t SubDim() const { return m_sub_dim; }
+
+        // [subspace][centroid][SubDim()] floats
+        std::span<const float> Codebook() const { return m_codebook; }
+
+    private:
+        float* Centroid(size_t m, size_t c) { return &m_codebook[(m * PQ_CENTROIDS + c) * m_sub_dim]; }
+        const float* Centroid(size_t m, size_t c) const { return &m_codebook[(m * PQ_CENTROIDS + c) * m_sub_dim]; }
+
+        // Index of the centroid of subspace 'm' nearest to 'sub'
+        uint8_t Nearest(size_t m, const float* sub) const;
+
+        size_t m_dim;
+        size_t m_subspaces;
+        size_t m_sub_dim;
+        std::vector<float> m_codebook;
+    };
+
+} // namespace Hyperion::Math
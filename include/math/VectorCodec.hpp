@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include "math/Math.hpp"
+
+namespace Hyperion::Math {
+
+    // Encoding of a vector-log record's codes. Values are stored on disk; never renumber.
+    enum class VectorCodec : uint8_t {
+        SQ8 = 1,    // int8 per element, per-vector min/max
+        SQ4 = 2,    // 4 bits per element, per-vector min/max
+        Binary = 3, // 1 bit per element, thresholded at the vector's mean
+        PQ = 4      // 1 byte per subspace, shared codebook (see ProductQuantizer)
+    };
+
+    /**
+     * @brief Fixed 16-byte prefix of every vector-log record.
+     *
+     *  [dim u16] [codec u8] [reserved u8] [size u32] [params 8 bytes] [codes ...] [pad]
+     *
+     * 'size' covers the whole record including padding to 8 bytes, so a reader can
+     * walk a log that mixes dimensions and codecs. For SQ8 / SQ4 / Binary the params
+     * are QuantParams; for PQ they are the subspace count.
+     */
+    struct VectorRecordHeader {
+        uint16_t dim;
+        VectorCodec codec;
+        uint8_t reserved;
+        uint32_t size;
+        union {
+            QuantParams quant;
+            struct {
+                uint32_t subspaces;
+                uint32_t reserved;
+            } pq;
+        } params;
+    };
+    static_assert(sizeof(VectorRecordHeader) == 16, "Vector record header is part of the log format");
+
+    inline constexpr size_t CodeBytes(VectorCodec codec, size_t dim, size_t subspaces) {
+        switch (codec) {
+            case VectorCodec::SQ8: return dim;
+            case VectorCodec::SQ4: return (dim + 1) / 2;
+            case VectorCodec::Binary: return (dim + 7) / 8;
+            case VectorCodec::PQ: return subspaces;
+        }
+        return 0;
+    }
+
+    // Header + codes, padded so every record in the log starts 8-byte aligned
+    inline constexpr size_t RecordBytes(VectorCodec codec, size_t dim, size_t subspaces) {
+        return (sizeof(VectorRecordHeader) + CodeBytes(codec, dim, subspaces) + 7) & ~size_t{7};
+    }
+
+    inline const char* CodecName(VectorCodec codec) {
+        switch (codec) {
+            case VectorCodec::SQ8: return "sq8";
+            case VectorCodec::SQ4: return "sq4";
+            case VectorCodec::Binary: return "binary";
+            case VectorCodec::PQ: return "pq";
+        }
+        return "unknown";
+    }
+
+    inline std::optional<VectorCodec> ParseCodec(std::string_view name) {
+        if (name == "sq8") return VectorCodec::SQ8;
+        if (name == "sq4") return VectorCodec::SQ4;
+        if (name == "binary") return VectorCodec::Binary;
+        if (name == "pq") return VectorCodec::PQ;
+        return std::nullopt;
+    }
+
+    // Header for a record; the caller writes the codes right after it
+    inline void WriteRecordHeader(char* dest, VectorCodec codec, size_t dim, size_t subspaces, QuantParams params) {
+        VectorRecordHeader header{};
+        header.dim = static_cast<uint16_t>(dim);
+        header.codec = codec;
+        header.size = static_cast<uint32_t>(RecordBytes(codec, dim, subspaces));
+        if (codec == VectorCodec::PQ) {
+            header.params.pq.subspaces = static_cast<uint32_t>(subspaces);
+        } else {
+            header.params.quant = params;
+        }
+        std::memcpy(dest, &header, sizeof(header));
+    }
+
+} // namespace Hyperion::Math
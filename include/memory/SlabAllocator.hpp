@@ -3,8 +3,14 @@
 #include <cstdint>
 #include <atomic>
 #include <cstddef>
+#include <memory>
+#include <ostream>
+#include <chrono>
+#include <thread>
 #include <new> // For std::launder if needed, or placement new
 
+#include "core/CpuRelax.hpp"
+
 namespace Cognitron::Core {
 
     /**
@@ -13,7 +19,7 @@ namespace Cognitron::Core {
      *  
      *  Base Address (64-byte aligned)
      *  +-----------------------------------------------------------------------+
-     *  | Global Allocator Header (Control Struct)                              |
+     *  | Superblock (TLSF Index, Roots, Magazines) + Span Map                   |
      *  +-----------------------------------------------------------------------+
      *  |                                                                       |
      *  | [ Block Header (64 bytes) ]                                           |
@@ -44,39 +50,158 @@ namespace Cognitron::Core {
      *  2. Cache Line alignment (64 bytes) prevents "False Sharing" where
      *     updates to a header by one core invalidate the cache line for a 
      *     neighboring block processed by another core.
+     *
+     *  COMPACT LAYOUT (BlockLayout::Compact)
+     *  =====================================
+     *
+     *  +----------------+---------------------------------------------+
+     *  | Header (8 B)   | USER PAYLOAD (16-byte aligned, runs to end) |   USED
+     *  +----------------+---------------------------------------------+
+     *  | Header (8 B)   | Next | Prev | ... Unused ...   | Footer (8) |   FREE
+     *  +----------------+---------------------------------------------+
+     *
+     *  Used blocks carry no footer. Instead every header has a PREV_FREE bit, and
+     *  only a free block's footer is ever read (to find its start when merging
+     *  left). Callers that need SIMD/cache-line alignment pass alignment = 64 to
+     *  Allocate(); everybody else pays 8 bytes instead of ~72 per block.
      */
 
-    // --- High-Performance Spinlock ---
-    class Spinlock {
+    // --- Queued Lock ---
+
+    // Called by a waiter that has spun past its budget. The runtime installs a hook
+    // that parks the current fiber when the waiter is on the scheduler thread; the
+    // default yields the OS thread.
+    using LockYieldHook = void (*)();
+
+    inline std::atomic<LockYieldHook> g_lock_yield_hook{nullptr};
+
+    inline void SetLockYieldHook(LockYieldHook hook) noexcept {
+        g_lock_yield_hook.store(hook, std::memory_order_release);
+    }
+
+    /**
+     * @brief Test-and-test-and-set lock with exponential backoff and contention profiling.
+     *
+     * Waiters spin on a plain load, so the lock word stays shared in every waiter's
+     * cache until it is released. Only then do they retry the exchange, and a failed
+     * retry doubles the pause window (up to MAX_BACKOFF), so a release causes one
+     * burst of traffic instead of a constant stream. Past SPIN_BUDGET pauses the
+     * waiter yields (fiber or thread), which hands the CPU to a preempted holder on
+     * an oversubscribed machine.
+     *
+     * A strict FIFO (ticket/MCS) hand-off was measured and rejected: when waiters
+     * outnumber cores, the next owner is usually descheduled and every release
+     * stalls for a time slice.
+     *
+     * Wait time is measured for every contended acquisition. Hold time is sampled
+     * once every HOLD_SAMPLE_PERIOD acquisitions, to keep clock reads off the
+     * uncontended path. Only the holder writes the profile.
+     */
+    class BackoffLock {
     public:
+        static constexpr uint32_t MIN_BACKOFF = 4;           // Pauses after the first failed retry
+        static constexpr uint32_t MAX_BACKOFF = 1024;
+        static constexpr uint32_t SPIN_BUDGET = 16384;       // Pauses before yielding
+        static constexpr uint64_t HOLD_SAMPLE_PERIOD = 64;   // Power of two
+
         void lock() noexcept {
-            while (flag.test_and_set(std::memory_order_acquire)) {
-                // Hint to CPU that we are spinning (pause instruction)
-                // x86: _mm_pause(); ARM: __yield();
-                // keeping it portable C++20/standard dependent or simple for now
-#if defined(__x86_64__) || defined(_M_X64)
-                __builtin_ia32_pause();
-#elif defined(__aarch64__)
-                __builtin_arm_yield();
-#endif
+            if (!TryAcquire()) {
+                const uint64_t wait_start = NowNs();
+                uint32_t backoff = MIN_BACKOFF;
+                uint32_t spent = 0;
+                do {
+                    if (spent < SPIN_BUDGET) {
+                        for (uint32_t i = 0; i < backoff; ++i) Hyperion::Core::CpuRelax();
+                        spent += backoff;
+                        if (backoff < MAX_BACKOFF) backoff *= 2;
+                    } else if (LockYieldHook hook = g_lock_yield_hook.load(std::memory_order_acquire)) {
+                        hook();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                } while (!TryAcquire());
+
+                const uint64_t wait_ns = NowNs() - wait_start;
+                Add(m_contended, 1);
+                Add(m_wait_ns, wait_ns);
+                if (wait_ns > m_max_wait_ns.load(std::memory_order_relaxed)) {
+                    m_max_wait_ns.store(wait_ns, std::memory_order_relaxed);
+                }
             }
+
+            // Only the holder writes the profile, so no RMW is needed
+            const uint64_t acquisitions = m_acquisitions.load(std::memory_order_relaxed);
+            m_acquisitions.store(acquisitions + 1, std::memory_order_relaxed);
+            m_acquired_at = (acquisitions & (HOLD_SAMPLE_PERIOD - 1)) == 0 ? NowNs() : 0;
         }
 
         void unlock() noexcept {
-            flag.clear(std::memory_order_release);
+            if (m_acquired_at != 0) {
+                const uint64_t hold_ns = NowNs() - m_acquired_at;
+                Add(m_hold_sampled_ns, hold_ns);
+                Add(m_hold_samples, 1);
+                if (hold_ns > m_max_hold_ns.load(std::memory_order_relaxed)) {
+                    m_max_hold_ns.store(hold_ns, std::memory_order_relaxed);
+                }
+            }
+            m_locked.store(false, std::memory_order_release);
+        }
+
+        // Forces the lock open, e.g. when reattaching to a lock left behind by a dead process
+        void Reset() noexcept {
+            m_locked.store(false, std::memory_order_release);
+        }
+
+        // Contention profile (approximate when read without holding the lock)
+        uint64_t acquisitions() const { return m_acquisitions.load(std::memory_order_relaxed); }
+        uint64_t contended() const { return m_contended.load(std::memory_order_relaxed); }
+        uint64_t wait_ns() const { return m_wait_ns.load(std::memory_order_relaxed); }
+        uint64_t max_wait_ns() const { return m_max_wait_ns.load(std::memory_order_relaxed); }
+        uint64_t max_hold_ns() const { return m_max_hold_ns.load(std::memory_order_relaxed); }
+
+        // Mean of the sampled hold times
+        uint64_t avg_hold_ns() const {
+            uint64_t samples = m_hold_samples.load(std::memory_order_relaxed);
+            return samples == 0 ? 0 : m_hold_sampled_ns.load(std::memory_order_relaxed) / samples;
         }
 
     private:
-        std::atomic_flag flag = ATOMIC_FLAG_INIT;
+        bool TryAcquire() noexcept {
+            // Test before test-and-set: a failed exchange would still steal the line
+            return !m_locked.load(std::memory_order_relaxed) &&
+                   !m_locked.exchange(true, std::memory_order_acquire);
+        }
+
+        static uint64_t NowNs() noexcept {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        static void Add(std::atomic<uint64_t>& counter, uint64_t delta) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        // Polled by waiters; kept off the line the holder writes its profile to
+        alignas(64) std::atomic<bool> m_locked{false};
+
+        // Holder-only profile
+        alignas(64) uint64_t m_acquired_at = 0; // Non-zero when this acquisition is sampled
+        std::atomic<uint64_t> m_acquisitions{0}; // Successful lock() calls
+        std::atomic<uint64_t> m_contended{0};    // lock() calls that had to wait
+        std::atomic<uint64_t> m_wait_ns{0};
+        std::atomic<uint64_t> m_max_wait_ns{0};
+        std::atomic<uint64_t> m_hold_sampled_ns{0};
+        std::atomic<uint64_t> m_hold_samples{0};
+        std::atomic<uint64_t> m_max_hold_ns{0};
     };
 
-    // RAII Wrapper for Spinlock
-    class SpinLockGuard {
+    // RAII Wrapper for BackoffLock
+    class BackoffLockGuard {
     public:
-        explicit SpinLockGuard(Spinlock& lock) : m_lock(lock) { m_lock.lock(); }
-        ~SpinLockGuard() { m_lock.unlock(); }
+        explicit BackoffLockGuard(BackoffLock& lock) : m_lock(lock) { m_lock.lock(); }
+        ~BackoffLockGuard() { m_lock.unlock(); }
     private:
-        Spinlock& m_lock;
+        BackoffLock& m_lock;
     };
 
     // --- Block Headers & Footers ---
@@ -84,28 +209,46 @@ namespace Cognitron::Core {
     constexpr size_t ALIGNMENT = 64;
     constexpr size_t MIN_BLOCK_SIZE = 128; // Header(64) + Payload(min 8) + Footer(8) -> Round up
 
-    // Aligned Header to ensure Payload starts at 64-byte boundary and avoid false sharing
-    struct alignas(ALIGNMENT) BlockHeader {
-        uint64_t size_and_state; // [63 bits: Size][1 bit: IsFree]
+    // Block payload layouts (chosen per allocator instance)
+    enum class BlockLayout : uint8_t {
+        CacheLine, // 64-byte header slot, footer on every block, payloads 64-aligned
+        Compact    // 8-byte header, footer on free blocks only, payloads 16-aligned
+    };
+
+    constexpr size_t CACHELINE_HEADER_SIZE = ALIGNMENT; // Header word padded to a cache line
+    constexpr size_t COMPACT_HEADER_SIZE = 8;
+    constexpr size_t COMPACT_GRANULE = 16;
+
+    // Header word. Block sizes are multiples of the layout granule (>= 16), so the low
+    // four bits are free for state. In the CacheLine layout it sits at the start of a
+    // 64-byte slot so the payload starts at a 64-byte boundary and avoids false sharing.
+    struct BlockHeader {
+        uint64_t size_and_state; // [60 bits: Size][2 spare][1 bit: PrevFree][1 bit: IsFree]
 
         static constexpr uint64_t FREE_MASK = 1ULL;
-        static constexpr uint64_t SIZE_MASK = ~FREE_MASK;
+        static constexpr uint64_t PREV_FREE_MASK = 2ULL;
+        static constexpr uint64_t SIZE_MASK = ~0xFULL;
 
         uint64_t GetSize() const { return size_and_state & SIZE_MASK; }
         bool IsFree() const { return (size_and_state & FREE_MASK) != 0; }
+        bool IsPrevFree() const { return (size_and_state & PREV_FREE_MASK) != 0; }
         
-        void Set(uint64_t size, bool free) {
-            size_and_state = (size & SIZE_MASK) | (free ? FREE_MASK : 0);
+        void Set(uint64_t size, bool free, bool prev_free) {
+            size_and_state = (size & SIZE_MASK) | (free ? FREE_MASK : 0) | (prev_free ? PREV_FREE_MASK : 0);
         }
         
         void SetFree(bool free) {
             if (free) size_and_state |= FREE_MASK;
-            else size_and_state &= SIZE_MASK;
+            else size_and_state &= ~FREE_MASK;
+        }
+
+        void SetPrevFree(bool prev_free) {
+            if (prev_free) size_and_state |= PREV_FREE_MASK;
+            else size_and_state &= ~PREV_FREE_MASK;
         }
 
         void SetSize(uint64_t size) {
-            bool free = IsFree();
-            size_and_state = (size & SIZE_MASK) | (free ? FREE_MASK : 0);
+            size_and_state = (size & SIZE_MASK) | (size_and_state & ~SIZE_MASK);
         }
     };
 
@@ -120,248 +263,1078 @@ namespace Cognitron::Core {
         uint64_t prev_offset; // Relative offset from Base
     };
 
+    /**
+     *  SMALL-OBJECT TIER (up to 4 KB)
+     *  ==============================
+     *
+     *  Requests up to SMALL_MAX_SIZE never touch the boundary-tag free list. They are
+     *  served from 64 KB "spans" carved out of the large-object heap, one size class
+     *  per span, with NO per-object header:
+     *
+     *  Span Payload (SPAN_SIZE aligned)
+     *  +-----------------------------------------------------------------------+
+     *  | [ Span Header (64 bytes) ]  class | owner slot | bump | local | remote |
+     *  +-----------------------------------------------------------------------+
+     *  | [ Object 0 ] [ Object 1 ] [ Object 2 ] ...           (class_size each) |
+     *  +-----------------------------------------------------------------------+
+     *
+     *  - Every span is owned by one thread slot. The owner allocates and frees through
+     *    its "magazine" (current span + partial list) without any atomic RMW.
+     *  - Frees from other threads push onto the span's lock-free remote list (Treiber
+     *    push). The owner takes the whole list with a single exchange when its local
+     *    list runs dry, so there is no pop-side ABA.
+     *  - A full span is on no list. The first free that reaches it queues it on the
+     *    owner's partial list (the owner's own frees directly, remote frees through a
+     *    lock-free stack), so a refill never looks at spans with nothing to give.
+     *  - A bitmap over SPAN_SIZE chunks of the heap marks which chunks are spans.
+     *    Free() uses it to route an offset to the right tier in O(1).
+     *
+     *  A refill keeps at most one completely free span per magazine and returns the
+     *  others to the large-object heap. The global lock is only taken to carve or
+     *  release spans.
+     */
+
+    constexpr size_t SPAN_SIZE = 64 * 1024;
+    constexpr size_t SMALL_MAX_SIZE = 4096;
+    constexpr uint32_t MAX_THREAD_SLOTS = 64;
+
+    // Size classes: 16-byte steps up to 128, 32-byte steps up to 256, 64-byte steps up
+    // to 512, then four steps per power of two. The CacheLine layout only uses the
+    // multiples of ALIGNMENT, so its objects stay cache-line aligned; the Compact
+    // layout uses all of them, so a 24-byte node costs 32 bytes instead of 64.
+    inline constexpr uint32_t SIZE_CLASSES[] = {
+        16, 32, 48, 64, 80, 96, 112, 128,
+        160, 192, 224, 256, 320, 384, 448, 512,
+        640, 768, 896, 1024, 1280, 1536, 1792, 2048,
+        2560, 3072, 3584, 4096
+    };
+    constexpr size_t NUM_SIZE_CLASSES = sizeof(SIZE_CLASSES) / sizeof(SIZE_CLASSES[0]);
+    constexpr size_t SIZE_CLASS_STEP = COMPACT_GRANULE;
+
+    // O(1) size -> class lookup per layout, indexed by ceil(size / SIZE_CLASS_STEP)
+    struct SizeClassTable {
+        uint8_t index[SMALL_MAX_SIZE / SIZE_CLASS_STEP + 1];
+    };
+
+    inline constexpr SizeClassTable MakeSizeClassTable(size_t granule) {
+        SizeClassTable table{};
+        size_t cls = 0;
+        for (size_t units = 0; units <= SMALL_MAX_SIZE / SIZE_CLASS_STEP; ++units) {
+            while (SIZE_CLASSES[cls] < units * SIZE_CLASS_STEP || SIZE_CLASSES[cls] % granule != 0) ++cls;
+            table.index[units] = static_cast<uint8_t>(cls);
+        }
+        return table;
+    }
+
+    inline constexpr SizeClassTable CACHELINE_SIZE_CLASSES = MakeSizeClassTable(ALIGNMENT);
+    inline constexpr SizeClassTable COMPACT_SIZE_CLASSES = MakeSizeClassTable(COMPACT_GRANULE);
+
+    // Objects sit at span + 64 + k * class_size, so an object is 'align'-aligned when its
+    // class is a multiple of 'align'. Allocate() rounds the size up to the requested
+    // alignment; this holds iff that rounding always lands on such a class.
+    inline constexpr bool AlignedRoundingLandsOnAlignedClass(const SizeClassTable& table) {
+        for (size_t align = SIZE_CLASS_STEP; align <= ALIGNMENT; align *= 2) {
+            for (size_t size = align; size <= SMALL_MAX_SIZE; size += align) {
+                if (SIZE_CLASSES[table.index[size / SIZE_CLASS_STEP]] % align != 0) return false;
+            }
+        }
+        return true;
+    }
+    static_assert(AlignedRoundingLandsOnAlignedClass(CACHELINE_SIZE_CLASSES));
+    static_assert(AlignedRoundingLandsOnAlignedClass(COMPACT_SIZE_CLASSES));
+
+    inline uint32_t SizeClassIndex(size_t size, BlockLayout layout) noexcept {
+        const SizeClassTable& table = layout == BlockLayout::Compact ? COMPACT_SIZE_CLASSES : CACHELINE_SIZE_CLASSES;
+        return table.index[(size + SIZE_CLASS_STEP - 1) / SIZE_CLASS_STEP];
+    }
+
+    // Lives in the first cache line of every span
+    struct alignas(ALIGNMENT) SpanHeader {
+        uint16_t size_class;
+        uint16_t owner_slot;
+        std::atomic<uint32_t> listed; // 1 while current or on a partial list
+        uint64_t bump_offset;   // Next never-used object (owner only)
+        uint64_t span_end;      // One past the last usable byte
+        uint64_t local_free;    // Owner-only intrusive LIFO of freed objects
+        uint64_t next_span;     // Link in the owner's partial list
+        std::atomic<uint64_t> remote_free; // Cross-thread frees (lock-free push)
+        uint32_t live;          // Objects handed out minus frees folded in (owner only)
+        std::atomic<uint32_t> remote_frees; // Remote frees not yet folded into 'live'
+    };
+    static_assert(sizeof(SpanHeader) == ALIGNMENT, "SpanHeader must occupy exactly one cache line");
+
+    /**
+     * @brief Per-thread slot id shared by every allocator instance.
+     * Slots are recycled when a thread exits; the next thread to claim the slot
+     * inherits its spans, which is safe because the previous owner is gone.
+     * Returns MAX_THREAD_SLOTS when all slots are taken (callers fall back to the
+     * locked large-object path).
+     */
+    inline uint32_t ThreadSlot() noexcept {
+        static std::atomic<uint64_t> s_slots_in_use{0};
+
+        struct SlotLease {
+            uint32_t slot = MAX_THREAD_SLOTS;
+            SlotLease() {
+                uint64_t used = s_slots_in_use.load(std::memory_order_relaxed);
+                while (~used != 0) {
+                    uint32_t candidate = static_cast<uint32_t>(__builtin_ctzll(~used));
+                    if (s_slots_in_use.compare_exchange_weak(used, used | (1ULL << candidate),
+                                                             std::memory_order_acquire)) {
+                        slot = candidate;
+                        break;
+                    }
+                }
+            }
+            ~SlotLease() {
+                if (slot < MAX_THREAD_SLOTS) {
+                    s_slots_in_use.fetch_and(~(1ULL << slot), std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local SlotLease lease;
+        return lease.slot;
+    }
+
+    // --- Statistics ---
+
+    // Live counters, readable at any time without taking the allocator lock
+    struct SlabStats {
+        uint64_t heap_bytes = 0;          // Bytes managed by the boundary-tag heap
+        uint64_t reserve_bytes = 0;       // Bytes the heap may grow to
+        uint64_t grows = 0;               // Times the heap extended into its reserve
+        uint64_t large_allocs = 0;
+        uint64_t large_frees = 0;
+        uint64_t large_in_use_bytes = 0;  // Block bytes (headers included) held by large objects
+        uint64_t small_allocs = 0;
+        uint64_t small_frees = 0;
+        uint64_t small_in_use_bytes = 0;  // Size-class bytes held by small objects
+        uint64_t spans = 0;               // SPAN_SIZE blocks carved for the small tier
+        uint64_t failed_allocs = 0;       // Allocate() calls that returned 0
+        uint64_t lock_acquisitions = 0;
+        uint64_t lock_contended = 0;
+        uint64_t lock_wait_ns = 0;
+        uint64_t lock_max_wait_ns = 0;
+        uint64_t lock_avg_hold_ns = 0;    // Sampled
+        uint64_t lock_max_hold_ns = 0;
+    };
+
+    // Result of an O(n) walk over every block of the heap
+    struct HeapReport {
+        static constexpr uint32_t HISTOGRAM_BINS = 48; // Bin i: free blocks of [2^i, 2^(i+1)) bytes
+
+        SlabStats stats;
+        uint64_t blocks = 0;
+        uint64_t used_blocks = 0;
+        uint64_t free_blocks = 0;
+        uint64_t span_blocks = 0;
+        uint64_t used_bytes = 0;
+        uint64_t free_bytes = 0;
+        uint64_t largest_free = 0;
+        uint64_t free_histogram[HISTOGRAM_BINS] = {};
+
+        // First boundary-tag violation found (corrupt_offset == 0 means the heap is sane)
+        uint64_t corrupt_offset = 0;
+        const char* corruption = nullptr;
+
+        bool Valid() const { return corruption == nullptr; }
+
+        // 0 = all free memory is one block, -> 1 = free memory is shattered into crumbs.
+        // A rising value with a small largest_free is the early warning for OOM.
+        double Fragmentation() const {
+            return free_bytes == 0 ? 0.0 : 1.0 - static_cast<double>(largest_free) / static_cast<double>(free_bytes);
+        }
+    };
+
     // --- Slab Allocator ---
 
     class SlabAllocator {
     public:
-        SlabAllocator(char* base_addr, size_t total_size, uint64_t start_offset) 
+        static constexpr uint64_t SUPERBLOCK_MAGIC = 0xC06D51ABA110C8ULL;
+        static constexpr uint32_t SUPERBLOCK_VERSION = 2;
+        static constexpr uint32_t MAX_ROOTS = 16;
+
+        // [base_addr, base_addr + reserve_size) is the window the heap may ever use;
+        // only the first total_size bytes are formatted up front, the rest is claimed
+        // on OOM. reserve_size == 0 means a fixed-size heap. If the window already holds
+        // a superblock with the same geometry the heap is reopened as-is in O(1).
+        SlabAllocator(char* base_addr, size_t total_size, uint64_t start_offset,
+                      BlockLayout layout = BlockLayout::CacheLine,
+                      size_t reserve_size = 0) 
             : m_base(base_addr), 
               m_total_size(total_size), 
+              m_reserve_size(reserve_size > total_size ? reserve_size : total_size),
               m_base_offset(start_offset),
-              m_free_list_head_offset(0) // 0 implies null in our offset-based system
+              m_layout(layout)
         { 
-            Init();
+            ComputeGeometry();
+            if (!Reopen()) Init();
         }
 
-        // Initialize the memory region as one giant free block
+        // Formats the region: fresh superblock and one giant free block. Drops any
+        // previous contents, including the roots.
         void Init() {
-            SpinLockGuard guard(m_lock);
+            m_sb = new (m_base + m_superblock_adjust) Superblock{};
+            Superblock* sb = m_sb;
+            sb->magic = 0; // Published last, so a torn format is never reopened
+            sb->version = SUPERBLOCK_VERSION;
+            sb->layout = m_layout;
+            sb->base_offset = m_base_offset;
+            sb->reserve_size = m_reserve_size;
 
-            // Align start to 64 bytes
-            uintptr_t base = reinterpret_cast<uintptr_t>(m_base);
-            uintptr_t aligned_base = (base + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
-            size_t adjustment = aligned_base - base;
-            
-            // Adjust offsets
-            uint64_t effective_start = m_base_offset + adjustment;
-            uint64_t effective_size = m_total_size - adjustment;
-
-            // Ensure we have space for at least one block
-            if (effective_size < sizeof(BlockHeader) + sizeof(BlockFooter)) {
-                return; // Too small
+            // Reset the small-object tier: one bit per SPAN_SIZE chunk of the window
+            m_span_map = reinterpret_cast<std::atomic<uint64_t>*>(m_base + m_span_map_adjust);
+            for (size_t i = 0; i < SpanMapWords(); ++i) {
+                new (&m_span_map[i]) std::atomic<uint64_t>(0);
             }
 
             // Create Initial Giant Free Block
             // Start of Heap relative to Base
-            m_first_block_offset = effective_start; 
-
-            // Calculate Usable Size
-            // Block = Header + [Payload + Footer]
-            // We want the Payload to be aligned??
-            // Actually, if Header is 64-aligned, Payload is 64-aligned.
-            // effective_start is 64-aligned relative to 0 if m_base is aligned?
-            // We assume m_base + m_first_block_offset is 64-byte aligned.
-
-            // Setup Header
-            BlockHeader* header = GetPtr<BlockHeader>(m_first_block_offset);
-            uint64_t usable_size = effective_size - sizeof(BlockHeader) - sizeof(BlockFooter);
-            
-            // Align size down to maintain end alignment
-            usable_size &= ~(ALIGNMENT - 1); // Not strictly necessary for size, but good for cleanliness
-            
-            header->Set(effective_size, true); // Total size including header/footer
+            sb->first_block_offset = m_base_offset + m_first_block_adjust;
+            sb->heap_end = sb->first_block_offset;
+            sb->reserve_end = sb->first_block_offset;
+            if (m_reserve_size > m_first_block_adjust) {
+                sb->reserve_end += (m_reserve_size - m_first_block_adjust) & ~(m_granule - 1);
+            }
+            sb->end_prev_free = false;
 
-            // Setup Footer
-            BlockFooter* footer = GetFooter(header);
-            footer->size_and_state = header->size_and_state;
+            // Ensure we have space for at least one block; otherwise the heap starts
+            // empty and the first allocation grows it
+            uint64_t effective_size = (m_total_size > m_first_block_adjust)
+                ? (m_total_size - m_first_block_adjust) & ~(m_granule - 1)
+                : 0;
+            if (effective_size >= m_min_block) {
+                // Block = Header + [Payload + Footer]. Sizes stay granule multiples, so every
+                // later payload inherits the first one's alignment.
+                // We assume m_base and m_base_offset agree modulo the granule.
+                sb->heap_end = sb->first_block_offset + effective_size;
 
-            // Setup Free Node
-            FreeNode* node = GetPayload<FreeNode>(header);
-            node->next_offset = 0;
-            node->prev_offset = 0;
+                // Setup Header & Footer
+                BlockHeader* header = GetPtr<BlockHeader>(sb->first_block_offset);
+                header->Set(effective_size, true, false); // Total size including header/footer
+                UpdateFooter(header);
 
-            m_free_list_head_offset = m_first_block_offset;
+                InsertFree(sb->first_block_offset);
+                sb->end_prev_free = true;
+            }
+
+            std::atomic_ref<uint64_t>(sb->magic).store(SUPERBLOCK_MAGIC, std::memory_order_release);
+            m_reopened = false;
         }
 
-        uint64_t Allocate(size_t size) {
-            if (size == 0) return 0;
+        // True when the constructor attached to an existing heap instead of formatting
+        bool WasReopened() const { return m_reopened; }
 
-            // 1. Enforce Alignment on Size
-            // We need enough space for Payload + Footer, aligned to 64
-            size_t footer_size = sizeof(BlockFooter);
-            size_t payload_size = (size + 63) & ~63; // User aligned size
-            
-            // Total block size needed = Header + Payload + Footer
-            // But we actually split blocks.
-            // Minimum size logic?
-            size_t required_total_size = sizeof(BlockHeader) + payload_size + footer_size;
-            // Round up total size to alignment to keep next block headers aligned
-            required_total_size = (required_total_size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
-
-            SpinLockGuard guard(m_lock);
-
-            // 2. First-Fit Search
-            uint64_t curr_offset = m_free_list_head_offset;
-            while (curr_offset != 0) {
-                BlockHeader* header = GetPtr<BlockHeader>(curr_offset);
-                FreeNode* free_node = GetPayload<FreeNode>(header);
-
-                if (header->GetSize() >= required_total_size) {
-                    // FOUND
-                    uint64_t remaining_size = header->GetSize() - required_total_size;
-
-                    // 3. Split if enough space remains
-                    // We need enough for a new Header + Min Payload + Footer
-                    if (remaining_size >= sizeof(BlockHeader) + 64 + sizeof(BlockFooter)) {
-                        
-                        // Shrink current block
-                        header->Set(required_total_size, false);
-                        UpdateFooter(header);
-
-                        // Create new Free Block
-                        uint64_t new_block_offset = curr_offset + required_total_size;
-                        BlockHeader* new_header = GetPtr<BlockHeader>(new_block_offset);
-                        new_header->Set(remaining_size, true);
-                        UpdateFooter(new_header);
-
-                        // Insert New Block into Free List in place of current
-                        FreeNode* new_node = GetPayload<FreeNode>(new_header);
-                        new_node->prev_offset = free_node->prev_offset;
-                        new_node->next_offset = free_node->next_offset;
-
-                        // Fix Links
-                        if (new_node->prev_offset != 0) {
-                            BlockHeader* prev = GetPtr<BlockHeader>(new_node->prev_offset);
-                            GetPayload<FreeNode>(prev)->next_offset = new_block_offset;
-                        } else {
-                            m_free_list_head_offset = new_block_offset;
-                        }
+        // Persistent root slots: offsets (or any word) that must survive a reopen,
+        // e.g. a graph entry point. 0 means unset.
+        uint64_t GetRoot(uint32_t index) const {
+            return index < MAX_ROOTS ? m_sb->roots[index].load(std::memory_order_acquire) : 0;
+        }
 
-                        if (new_node->next_offset != 0) {
-                            BlockHeader* next = GetPtr<BlockHeader>(new_node->next_offset);
-                            GetPayload<FreeNode>(next)->prev_offset = new_block_offset;
-                        }
+        void SetRoot(uint32_t index, uint64_t value) {
+            if (index < MAX_ROOTS) m_sb->roots[index].store(value, std::memory_order_release);
+        }
 
-                    } else {
-                        // Use whole block
-                        header->SetUsed(false); // Used
-                        // Remove from free list
-                        if (free_node->prev_offset != 0) {
-                            BlockHeader* prev = GetPtr<BlockHeader>(free_node->prev_offset);
-                            GetPayload<FreeNode>(prev)->next_offset = free_node->next_offset;
-                        } else {
-                            m_free_list_head_offset = free_node->next_offset;
-                        }
+        // 'alignment' = 0 uses the layout's natural payload alignment (64 for CacheLine,
+        // 16 for Compact). Larger powers of two are honoured by trimming a bigger block.
+        uint64_t Allocate(size_t size, size_t alignment = 0) {
+            if (size == 0) return 0;
 
-                        if (free_node->next_offset != 0) {
-                            BlockHeader* next = GetPtr<BlockHeader>(free_node->next_offset);
-                            GetPayload<FreeNode>(next)->prev_offset = free_node->prev_offset;
-                        }
-                        
-                        // Mark Header/Footer as Used
-                        header->SetFree(false);
-                        UpdateFooter(header);
+            // Small objects: per-thread magazine, no lock, no header. Rounding the size to
+            // the alignment picks a class whose objects all have it (see SIZE_CLASSES).
+            if (size <= SMALL_MAX_SIZE && alignment <= ALIGNMENT) {
+                uint32_t slot = ThreadSlot();
+                if (slot < MAX_THREAD_SLOTS) {
+                    size_t rounded = alignment > 1 ? (size + alignment - 1) & ~(alignment - 1) : size;
+                    uint32_t size_class = SizeClassIndex(rounded, m_layout);
+                    uint64_t offset = AllocateSmall(slot, size_class);
+                    if (offset != 0) {
+                        SlotCounters& counters = m_sb->thread_caches[slot].counters;
+                        Bump(counters.allocs, 1);
+                        Bump(counters.alloc_bytes, SIZE_CLASSES[size_class]);
+                        return offset;
                     }
-
-                    // Return Payload Offset
-                    return curr_offset + sizeof(BlockHeader);
                 }
+            }
 
-                curr_offset = free_node->next_offset;
+            uint64_t offset;
+            if (alignment > m_granule) {
+                BackoffLockGuard guard(m_sb->lock);
+                offset = AllocateAlignedLocked(size, alignment);
+                if (offset != 0) CountLargeAllocLocked(offset);
+            } else {
+                offset = AllocateLarge(size);
             }
 
-            return 0; // OOM
+            if (offset == 0) m_sb->failed_allocs.fetch_add(1, std::memory_order_relaxed);
+            return offset;
         }
 
         void Free(uint64_t payload_offset, size_t size_hint = 0) {
             if (payload_offset == 0) return;
 
-            SpinLockGuard guard(m_lock);
+            if (IsSmallObject(payload_offset)) {
+                FreeSmall(payload_offset);
+                return;
+            }
+
+            FreeLarge(payload_offset, size_hint);
+        }
+
+        template<typename T>
+        T* GetPtr(uint64_t offset) {
+            return reinterpret_cast<T*>(m_base + (offset - m_base_offset));
+        }
+
+        // Inverse of GetPtr, for callers that hand out raw pointers (e.g. pmr adapters)
+        uint64_t GetOffset(const void* ptr) const {
+            return m_base_offset + static_cast<uint64_t>(static_cast<const char*>(ptr) - m_base);
+        }
+
+        // Payload alignment every Allocate() gets without asking
+        size_t NaturalAlignment() const { return m_granule; }
+
+        // --- Introspection ---
+
+        SlabStats GetStats() const {
+            SlabStats stats;
+            // heap_end moves under the lock (GrowLocked); the other bounds are fixed by Init()
+            uint64_t heap_end = std::atomic_ref<uint64_t>(m_sb->heap_end).load(std::memory_order_acquire);
+            stats.heap_bytes = heap_end - m_sb->first_block_offset;
+            stats.reserve_bytes = m_sb->reserve_end - m_sb->first_block_offset;
+            stats.grows = m_sb->grows.load(std::memory_order_relaxed);
+            stats.large_allocs = m_sb->large_allocs.load(std::memory_order_relaxed);
+            stats.large_frees = m_sb->large_frees.load(std::memory_order_relaxed);
+            stats.large_in_use_bytes = m_sb->large_in_use.load(std::memory_order_relaxed);
+            stats.spans = m_sb->span_count.load(std::memory_order_relaxed);
+            stats.failed_allocs = m_sb->failed_allocs.load(std::memory_order_relaxed);
+
+            // Per-slot counters are single-writer; the sum is a consistent-enough snapshot
+            uint64_t small_alloc_bytes = 0;
+            uint64_t small_free_bytes = m_sb->unslotted_free_bytes.load(std::memory_order_relaxed);
+            stats.small_frees = m_sb->unslotted_frees.load(std::memory_order_relaxed);
+            for (const auto& cache : m_sb->thread_caches) {
+                stats.small_allocs += cache.counters.allocs.load(std::memory_order_relaxed);
+                stats.small_frees += cache.counters.frees.load(std::memory_order_relaxed);
+                small_alloc_bytes += cache.counters.alloc_bytes.load(std::memory_order_relaxed);
+                small_free_bytes += cache.counters.free_bytes.load(std::memory_order_relaxed);
+            }
+            stats.small_in_use_bytes = small_alloc_bytes > small_free_bytes ? small_alloc_bytes - small_free_bytes : 0;
+
+            stats.lock_acquisitions = m_sb->lock.acquisitions();
+            stats.lock_contended = m_sb->lock.contended();
+            stats.lock_wait_ns = m_sb->lock.wait_ns();
+            stats.lock_max_wait_ns = m_sb->lock.max_wait_ns();
+            stats.lock_avg_hold_ns = m_sb->lock.avg_hold_ns();
+            stats.lock_max_hold_ns = m_sb->lock.max_hold_ns();
+            return stats;
+        }
+
+        // Walks every block under the lock, validating the boundary tags and the TLSF
+        // index, and measures fragmentation. O(blocks); meant for monitoring, not hot paths.
+        HeapReport WalkHeap() {
+            HeapReport report;
+            BackoffLockGuard guard(m_sb->lock);
+
+            auto fail = [&report](uint64_t offset, const char* reason) {
+                report.corrupt_offset = offset;
+                report.corruption = reason;
+            };
+
+            uint64_t offset = m_sb->first_block_offset;
+            bool prev_free = false;
+            while (offset < m_sb->heap_end && report.Valid()) {
+                BlockHeader* header = GetPtr<BlockHeader>(offset);
+                uint64_t size = header->GetSize();
+
+                if (size < m_min_block || size % m_granule != 0 || offset + size > m_sb->heap_end) {
+                    fail(offset, "block size out of range");
+                    break;
+                }
+                if (header->IsPrevFree() != prev_free) {
+                    fail(offset, "PREV_FREE bit disagrees with previous block");
+                    break;
+                }
+
+                ++report.blocks;
+                if (header->IsFree()) {
+                    if (prev_free) {
+                        fail(offset, "adjacent free blocks were not coalesced");
+                        break;
+                    }
+                    if (GetFooter(header)->size_and_state != header->size_and_state) {
+                        fail(offset, "free block footer does not match header");
+                        break;
+                    }
+                    ++report.free_blocks;
+                    report.free_bytes += size;
+                    if (size > report.largest_free) report.largest_free = size;
+                    uint32_t bin = 63 - static_cast<uint32_t>(__builtin_clzll(size));
+                    if (bin >= HeapReport::HISTOGRAM_BINS) bin = HeapReport::HISTOGRAM_BINS - 1;
+                    report.free_histogram[bin]++;
+                } else {
+                    if (m_layout == BlockLayout::CacheLine &&
+                        (GetFooter(header)->size_and_state & BlockHeader::SIZE_MASK) != size) {
+                        fail(offset, "used block footer does not match header");
+                        break;
+                    }
+                    ++report.used_blocks;
+                    report.used_bytes += size;
+                    if (IsSmallObject(offset + m_header_size)) ++report.span_blocks;
+                }
+
+                prev_free = header->IsFree();
+                offset += size;
+            }
+
+            if (report.Valid() && offset != m_sb->heap_end) {
+                fail(offset, "block chain does not end at the heap end");
+            }
+            if (report.Valid() && (m_sb->end_prev_free != 0) != prev_free) {
+                fail(offset, "heap-end PREV_FREE bit disagrees with last block");
+            }
+
+            // Every free block must be reachable from exactly the TLSF list its size maps to
+            uint64_t indexed = 0;
+            for (uint32_t fl = 0; fl < TLSF_FL_COUNT && report.Valid(); ++fl) {
+                for (uint32_t sl = 0; sl < TLSF_SL_COUNT && report.Valid(); ++sl) {
+                    bool listed = (m_sb->sl_bitmap[fl] >> sl) & 1U;
+                    if (listed != (m_sb->free_heads[fl][sl] != 0)) {
+                        fail(m_sb->free_heads[fl][sl], "TLSF bitmap disagrees with list head");
+                        break;
+                    }
+                    for (uint64_t node = m_sb->free_heads[fl][sl]; node != 0 && report.Valid();) {
+                        BlockHeader* header = GetPtr<BlockHeader>(node);
+                        uint32_t node_fl, node_sl;
+                        MapSize(header->GetSize(), node_fl, node_sl);
+                        if (!header->IsFree() || node_fl != fl || node_sl != sl) {
+                            fail(node, "TLSF list holds a misfiled block");
+                        } else if (++indexed > report.free_blocks) {
+                            fail(node, "TLSF lists hold more blocks than the heap");
+                        }
+                        node = GetPayload<FreeNode>(header)->next_offset;
+                    }
+                }
+            }
+            if (report.Valid() && indexed != report.free_blocks) {
+                fail(m_sb->first_block_offset, "free block missing from the TLSF index");
+            }
+
+            report.stats = GetStats();
+            return report;
+        }
+
+        // Human-readable dump of WalkHeap(): counters, fragmentation and free-size histogram
+        void DumpReport(std::ostream& os) {
+            HeapReport report = WalkHeap();
+            const SlabStats& st = report.stats;
+
+            os << "SlabAllocator @ offset 0x" << std::hex << m_base_offset << std::dec
+               << " (" << (m_layout == BlockLayout::Compact ? "compact" : "cache-line") << " layout)\n";
+            os << "  heap bytes        : " << st.heap_bytes << " of " << st.reserve_bytes
+               << " reserved (" << st.grows << " grows)\n";
+            os << "  large allocs/frees: " << st.large_allocs << " / " << st.large_frees
+               << " (" << st.large_in_use_bytes << " bytes in use)\n";
+            os << "  small allocs/frees: " << st.small_allocs << " / " << st.small_frees
+               << " (" << st.small_in_use_bytes << " bytes in use, " << st.spans << " spans)\n";
+            os << "  failed allocs     : " << st.failed_allocs << "\n";
+            os << "  lock              : " << st.lock_acquisitions << " acquisitions, "
+               << st.lock_contended << " contended\n";
+            os << "  lock wait (ns)    : " << st.lock_wait_ns << " total, " << st.lock_max_wait_ns << " max\n";
+            os << "  lock hold (ns)    : " << st.lock_avg_hold_ns << " avg (sampled), " << st.lock_max_hold_ns << " max\n";
+            os << "  blocks            : " << report.blocks << " (" << report.used_blocks << " used, "
+               << report.free_blocks << " free, " << report.span_blocks << " spans)\n";
+            os << "  free bytes        : " << report.free_bytes << " (largest " << report.largest_free << ")\n";
+            os << "  fragmentation     : " << static_cast<int>(report.Fragmentation() * 100.0) << "%\n";
+            os << "  free histogram    :\n";
+            for (uint32_t bin = 0; bin < HeapReport::HISTOGRAM_BINS; ++bin) {
+                if (report.free_histogram[bin] == 0) continue;
+                os << "    [2^" << bin << ", 2^" << (bin + 1) << "): " << report.free_histogram[bin] << "\n";
+            }
+            if (report.Valid()) {
+                os << "  boundary tags     : OK\n";
+            } else {
+                os << "  boundary tags     : CORRUPT at offset 0x" << std::hex << report.corrupt_offset
+                   << std::dec << " (" << report.corruption << ")\n";
+            }
+        }
+
+    private:
+        // --- Region Layout & Persistence ---
+
+        size_t SpanMapWords() const { return (m_span_chunks + 63) / 64; }
+
+        // Derives every layout-dependent constant and where the metadata sits in the
+        // region. Pure arithmetic on the constructor arguments, so Reopen() stays O(1).
+        void ComputeGeometry() {
+            if (m_layout == BlockLayout::Compact) {
+                m_header_size = COMPACT_HEADER_SIZE;
+                m_granule = COMPACT_GRANULE;
+                m_min_block = COMPACT_HEADER_SIZE + sizeof(FreeNode) + sizeof(BlockFooter);
+            } else {
+                m_header_size = CACHELINE_HEADER_SIZE;
+                m_granule = ALIGNMENT;
+                m_min_block = CACHELINE_HEADER_SIZE + 64 + sizeof(BlockFooter);
+            }
+            m_tlsf_fl_shift = TLSF_SL_LOG2 + static_cast<uint32_t>(__builtin_ctzll(m_granule));
+            m_tlsf_small_block = 1ULL << m_tlsf_fl_shift;
+
+            // One span-map bit per SPAN_SIZE chunk of the whole reserve
+            m_span_origin = m_base_offset & ~(SPAN_SIZE - 1);
+            m_span_chunks = (m_base_offset + m_reserve_size - m_span_origin + SPAN_SIZE - 1) / SPAN_SIZE;
+
+            // [Superblock][Span Map][Blocks ...]
+            uintptr_t base = reinterpret_cast<uintptr_t>(m_base);
+            uintptr_t superblock = (base + ALIGNMENT - 1) & ~(uintptr_t)(ALIGNMENT - 1);
+            uintptr_t span_map = superblock + sizeof(Superblock);
+            uintptr_t metadata_end = span_map + SpanMapWords() * sizeof(uint64_t);
+
+            // Place the first header so that its payload lands on a granule boundary
+            uintptr_t first_payload = (metadata_end + m_header_size + m_granule - 1) & ~(uintptr_t)(m_granule - 1);
+
+            m_superblock_adjust = superblock - base;
+            m_span_map_adjust = span_map - base;
+            m_first_block_adjust = first_payload - m_header_size - base;
+        }
+
+        // Attaches to a superblock left by a previous instance over the same window
+        bool Reopen() {
+            Superblock* sb = std::launder(reinterpret_cast<Superblock*>(m_base + m_superblock_adjust));
+            if (std::atomic_ref<uint64_t>(sb->magic).load(std::memory_order_acquire) != SUPERBLOCK_MAGIC ||
+                sb->version != SUPERBLOCK_VERSION ||
+                sb->layout != m_layout ||
+                sb->base_offset != m_base_offset ||
+                sb->reserve_size != m_reserve_size) {
+                return false;
+            }
+
+            m_sb = sb;
+            m_span_map = std::launder(reinterpret_cast<std::atomic<uint64_t>*>(m_base + m_span_map_adjust));
+
+            // A lock still held by a previous process is stale
+            m_sb->lock.Reset();
+            m_reopened = true;
+            return true;
+        }
+
+        // Extends the heap into the reserve so that a block of at least 'min_bytes'
+        // exists. The new space is released like a freed block, so it merges with a
+        // free tail. Pages are only touched for the new boundary tags.
+        bool GrowLocked(size_t min_bytes) {
+            Superblock* sb = m_sb;
+            uint64_t old_end = sb->heap_end;
+            uint64_t room = sb->reserve_end - old_end;
+            if (room < m_min_block) return false;
+
+            // Geometric growth keeps the number of grows logarithmic in the heap size
+            uint64_t grow = old_end - sb->first_block_offset;
+            if (grow < min_bytes * 2) grow = min_bytes * 2;
+            grow = (grow + HEAP_GROW_STEP - 1) & ~(uint64_t)(HEAP_GROW_STEP - 1);
+            if (grow > room) grow = room;
+            grow &= ~(uint64_t)(m_granule - 1);
+
+            BlockHeader* header = GetPtr<BlockHeader>(old_end);
+            header->Set(grow, false, sb->end_prev_free != 0);
+            // Locked code reads heap_end plainly; GetStats() reads it without the lock
+            std::atomic_ref<uint64_t>(sb->heap_end).store(old_end + grow, std::memory_order_release);
+            sb->end_prev_free = false;
+            ReleaseBlockLocked(old_end);
+
+            Bump(sb->grows, 1);
+            return true;
+        }
+
+        uint64_t FindOrGrowLocked(uint64_t size) {
+            uint64_t offset = FindFreeBlock(size);
+            if (offset == 0 && GrowLocked(size)) offset = FindFreeBlock(size);
+            return offset;
+        }
+
+        // --- Large-Object Backend (Boundary Tags, TLSF Index) ---
+
+        size_t BlockSizeFor(size_t payload) const {
+            if (m_layout == BlockLayout::Compact) {
+                // Used blocks have no footer: the payload runs to the end of the block
+                size_t total = (m_header_size + payload + m_granule - 1) & ~(m_granule - 1);
+                return total < m_min_block ? m_min_block : total;
+            }
+            // Header + Payload + Footer, rounded to keep the next header aligned
+            size_t total = m_header_size + ((payload + 63) & ~63) + sizeof(BlockFooter);
+            return (total + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+
+        uint64_t AllocateLarge(size_t size) {
+            size_t required_total_size = BlockSizeFor(size);
+
+            BackoffLockGuard guard(m_sb->lock);
+
+            // 1. Good-Fit Search: two bitmap scans, no list walk
+            uint64_t block_offset = FindOrGrowLocked(required_total_size);
+            if (block_offset == 0) return 0; // OOM
+
+            RemoveFromFreeList(block_offset);
+            BlockHeader* header = GetPtr<BlockHeader>(block_offset);
+            uint64_t remaining_size = header->GetSize() - required_total_size;
+
+            // 2. Split if enough space remains for a new Header + Min Payload + Footer
+            if (remaining_size >= m_min_block) {
+                header->SetSize(required_total_size);
+                header->SetFree(false);
+                UpdateFooter(header);
+
+                // The block after the remainder already has PREV_FREE set
+                uint64_t new_block_offset = block_offset + required_total_size;
+                BlockHeader* new_header = GetPtr<BlockHeader>(new_block_offset);
+                new_header->Set(remaining_size, true, false);
+                UpdateFooter(new_header);
+                InsertFree(new_block_offset);
+            } else {
+                // Use whole block
+                header->SetFree(false);
+                UpdateFooter(header);
+                SetNextPrevFree(block_offset, header->GetSize(), false);
+            }
+
+            Bump(m_sb->large_allocs, 1);
+            Bump(m_sb->large_in_use, header->GetSize());
+
+            // Return Payload Offset
+            return block_offset + m_header_size;
+        }
+
+        // --- Counters ---
+
+        // Single-writer increment (caller holds m_sb->lock or owns the slot)
+        static void Bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        void CountLargeAllocLocked(uint64_t payload_offset) {
+            Bump(m_sb->large_allocs, 1);
+            Bump(m_sb->large_in_use, GetPtr<BlockHeader>(payload_offset - m_header_size)->GetSize());
+        }
+
+        // Allocates a block whose payload offset is a multiple of 'align' (a power of two,
+        // >= ALIGNMENT). Leading/trailing slack large enough for a block is split off and
+        // returned to the free lists. Caller must hold m_sb->lock.
+        uint64_t AllocateAlignedLocked(size_t size, size_t align) {
+            size_t required_total_size = BlockSizeFor(size);
+
+            // Ask for enough slack that any block from the class can be trimmed into place
+            uint64_t curr_offset = FindOrGrowLocked(required_total_size + align + m_min_block);
+            if (curr_offset == 0) return 0; // OOM
+
+            BlockHeader* header = GetPtr<BlockHeader>(curr_offset);
+            uint64_t block_end = curr_offset + header->GetSize();
+            bool prev_free = header->IsPrevFree();
+
+            // Leading slack must be zero or big enough to stand alone as a free block
+            uint64_t payload = (curr_offset + m_header_size + align - 1) & ~(uint64_t)(align - 1);
+            uint64_t lead = payload - m_header_size - curr_offset;
+            if (lead != 0 && lead < m_min_block) {
+                payload += align;
+                lead += align;
+            }
+
+            uint64_t block_start = payload - m_header_size;
+            uint64_t tail = block_end - (block_start + required_total_size);
+            uint64_t used_size = (tail != 0 && tail < m_min_block) ? required_total_size + tail
+                                                                   : required_total_size;
+
+            RemoveFromFreeList(curr_offset);
+
+            if (lead != 0) {
+                header->Set(lead, true, prev_free);
+                UpdateFooter(header);
+                InsertFree(curr_offset);
+            }
+
+            BlockHeader* used = GetPtr<BlockHeader>(block_start);
+            used->Set(used_size, false, lead != 0 || prev_free);
+            UpdateFooter(used);
+
+            if (block_start + used_size < block_end) {
+                uint64_t tail_offset = block_start + used_size;
+                BlockHeader* tail_hdr = GetPtr<BlockHeader>(tail_offset);
+                tail_hdr->Set(block_end - tail_offset, true, false);
+                UpdateFooter(tail_hdr);
+                InsertFree(tail_offset);
+            } else {
+                SetNextPrevFree(block_start, used_size, false);
+            }
+
+            return payload;
+        }
+
+        void FreeLarge(uint64_t payload_offset, size_t size_hint = 0) {
+            (void)size_hint;
+
+            BackoffLockGuard guard(m_sb->lock);
 
             // Calculate Header Offset
-            uint64_t block_offset = payload_offset - sizeof(BlockHeader);
+            uint64_t block_offset = payload_offset - m_header_size;
             BlockHeader* header = GetPtr<BlockHeader>(block_offset);
 
             // Double Free check?
             if (header->IsFree()) return; 
 
+            Bump(m_sb->large_frees, 1);
+            Bump(m_sb->large_in_use, 0 - header->GetSize());
+
+            ReleaseBlockLocked(block_offset);
+        }
+
+        // Marks a block free, merges it with free neighbours and indexes the result
+        void ReleaseBlockLocked(uint64_t block_offset) {
+            BlockHeader* header = GetPtr<BlockHeader>(block_offset);
+
             // Mark as Free
             header->SetFree(true);
-            UpdateFooter(header);
 
             // COALESCE RIGHT
             // Check if next block exists and is free
             uint64_t next_block_offset = block_offset + header->GetSize();
-            if (next_block_offset < m_total_size + m_base_offset) { // Bounds check relies on accurate sizes
-                 // Wait, we need to be careful about strict bounds
-                 // Let's check pointer validity
+            if (next_block_offset < m_sb->heap_end) {
                  BlockHeader* next_hdr = GetPtr<BlockHeader>(next_block_offset);
-                 if (next_hdr && next_hdr->IsFree()) {
+                 if (next_hdr->IsFree()) {
                      // Merge!
                      RemoveFromFreeList(next_block_offset);
-                     
-                     uint64_t new_size = header->GetSize() + next_hdr->GetSize();
-                     header->SetSize(new_size);
-                     UpdateFooter(header);
+                     header->SetSize(header->GetSize() + next_hdr->GetSize());
                  }
             }
 
             // COALESCE LEFT
-            // Check prev block using footer
-            // We need to know where the prev footer IS.
-            // It is at block_offset - sizeof(BlockFooter)
-            if (block_offset > m_first_block_offset) {
+            // PREV_FREE says whether the previous block is free; only then is its footer
+            // (right before our header) guaranteed to be valid.
+            if (header->IsPrevFree()) {
                 BlockFooter* prev_footer = reinterpret_cast<BlockFooter*>(
                     reinterpret_cast<char*>(header) - sizeof(BlockFooter)
                 );
-                
-                // Decode footer
                 uint64_t prev_size = prev_footer->size_and_state & BlockHeader::SIZE_MASK;
-                bool prev_free = (prev_footer->size_and_state & BlockHeader::FREE_MASK) != 0;
-
-                if (prev_free) {
-                    uint64_t prev_offset = block_offset - prev_size;
-                    BlockHeader* prev_hdr = GetPtr<BlockHeader>(prev_offset);
-                    
-                    // Merge current into prev
-                    // Previous is already in free list? Yes.
-                    // We just extend it.
-                    // BUT we still need to add THIS block to free list if we didn't merge left?
-                    // Logic:
-                    // 1. If merge left: Prev becomes the "current" big block. We don't add "header" to free list, Prev is already there. we just grow it.
-                    // 2. If NO merge left: We add "header" to free list.
-                    
-                    uint64_t new_size = prev_hdr->GetSize() + header->GetSize();
-                    prev_hdr->SetSize(new_size);
-                    UpdateFooter(prev_hdr);
-                    
-                    // We are done. The 'Prev' block is already in the free list.
-                    return; 
+                uint64_t prev_offset = block_offset - prev_size;
+                BlockHeader* prev_hdr = GetPtr<BlockHeader>(prev_offset);
+
+                // Prev changes size class when it grows: unlink, grow, re-index.
+                RemoveFromFreeList(prev_offset);
+                prev_hdr->SetSize(prev_size + header->GetSize());
+                block_offset = prev_offset;
+                header = prev_hdr;
+            }
+
+            UpdateFooter(header);
+            InsertFree(block_offset);
+            SetNextPrevFree(block_offset, header->GetSize(), true);
+        }
+
+        // --- Small-Object Tier ---
+
+        struct Magazine {
+            uint64_t current_span = 0; // Span serving allocations right now
+            uint64_t partial = 0;      // Owner-queued spans with frees waiting (owner only)
+            std::atomic<uint64_t> remote_partial{0}; // Spans queued by remote frees (Treiber stack)
+        };
+
+        // Written only by the slot's owner thread
+        struct SlotCounters {
+            std::atomic<uint64_t> allocs{0};
+            std::atomic<uint64_t> frees{0};
+            std::atomic<uint64_t> alloc_bytes{0};
+            std::atomic<uint64_t> free_bytes{0};
+        };
+
+        struct alignas(ALIGNMENT) ThreadCache {
+            Magazine classes[NUM_SIZE_CLASSES];
+            SlotCounters counters;
+        };
+
+        bool IsSmallObject(uint64_t offset) const {
+            if (offset < m_span_origin) return false;
+            uint64_t chunk = (offset - m_span_origin) / SPAN_SIZE;
+            if (chunk >= m_span_chunks) return false;
+            uint64_t word = m_span_map[chunk / 64].load(std::memory_order_acquire);
+            return (word >> (chunk % 64)) & 1ULL;
+        }
+
+        uint64_t SpanOf(uint64_t offset) const {
+            return m_span_origin + ((offset - m_span_origin) & ~(uint64_t)(SPAN_SIZE - 1));
+        }
+
+        // Folds remote frees into the owner's view: the remote list into local_free and
+        // the remote count into 'live'. A freer bumps the count after its push, so 'live'
+        // never drops below the number of objects still out.
+        void CollectRemote(SpanHeader* span) {
+            if (span->local_free == 0 && span->remote_free.load(std::memory_order_relaxed) != 0) {
+                span->local_free = span->remote_free.exchange(0, std::memory_order_acquire);
+            }
+            if (span->remote_frees.load(std::memory_order_relaxed) != 0) {
+                span->live -= span->remote_frees.exchange(0, std::memory_order_acquire);
+            }
+        }
+
+        // Pops one object from a span: local list, then the drained remote list, then bump.
+        uint64_t PopFromSpan(SpanHeader* span) {
+            CollectRemote(span);
+
+            if (span->local_free != 0) {
+                uint64_t offset = span->local_free;
+                span->local_free = *GetPtr<uint64_t>(offset);
+                ++span->live;
+                return offset;
+            }
+
+            uint32_t object_size = SIZE_CLASSES[span->size_class];
+            if (span->bump_offset + object_size <= span->span_end) {
+                uint64_t offset = span->bump_offset;
+                span->bump_offset += object_size;
+                ++span->live;
+                return offset;
+            }
+
+            return 0; // Span exhausted
+        }
+
+        // Next span from the partial list, refilled from the remote stack when empty.
+        // The caller holds the span's 'listed' flag until it lists it again.
+        uint64_t PopPartial(Magazine& mag) {
+            if (mag.partial == 0) {
+                mag.partial = mag.remote_partial.exchange(0, std::memory_order_acquire);
+                if (mag.partial == 0) return 0;
+            }
+            uint64_t span_offset = mag.partial;
+            mag.partial = GetPtr<SpanHeader>(span_offset)->next_span;
+            return span_offset;
+        }
+
+        // Formats a span as fresh: empty lists, bump pointer at the first object
+        void ResetSpan(uint64_t span_offset, uint32_t slot, uint32_t size_class) {
+            SpanHeader* span = GetPtr<SpanHeader>(span_offset);
+            span->size_class = static_cast<uint16_t>(size_class);
+            span->owner_slot = static_cast<uint16_t>(slot);
+            span->listed.store(1, std::memory_order_relaxed);
+            span->bump_offset = span_offset + sizeof(SpanHeader);
+            span->span_end = span_offset + SPAN_SIZE;
+            span->local_free = 0;
+            span->next_span = 0;
+            span->remote_free.store(0, std::memory_order_relaxed);
+            span->live = 0;
+            span->remote_frees.store(0, std::memory_order_relaxed);
+        }
+
+        // Returns a chain of spans (linked through next_span) to the large-object heap
+        void ReleaseSpans(uint64_t span_offset) {
+            BackoffLockGuard guard(m_sb->lock);
+            while (span_offset != 0) {
+                uint64_t next = GetPtr<SpanHeader>(span_offset)->next_span;
+                uint64_t chunk = (span_offset - m_span_origin) / SPAN_SIZE;
+                m_span_map[chunk / 64].fetch_and(~(1ULL << (chunk % 64)), std::memory_order_release);
+                Bump(m_sb->span_count, 0 - uint64_t{1});
+                ReleaseBlockLocked(span_offset - m_header_size);
+                span_offset = next;
+            }
+        }
+
+        uint64_t AllocateSmall(uint32_t slot, uint32_t size_class) {
+            Magazine& mag = m_sb->thread_caches[slot].classes[size_class];
+
+            // 1. Fast path: the current span
+            if (mag.current_span != 0) {
+                SpanHeader* span = GetPtr<SpanHeader>(mag.current_span);
+                for (;;) {
+                    uint64_t offset = PopFromSpan(span);
+                    if (offset != 0) return offset;
+
+                    // Exhausted: unlist it so the next free queues it again. A remote free
+                    // that raced with the unlisting either sees listed == 0 and queues the
+                    // span, or is seen here (both sides are seq_cst).
+                    span->listed.store(0, std::memory_order_seq_cst);
+                    if (span->remote_free.load(std::memory_order_seq_cst) == 0 ||
+                        span->listed.exchange(1, std::memory_order_seq_cst) != 0) {
+                        break;
+                    }
+                }
+                mag.current_span = 0;
+            }
+
+            // 2. Reclaim: only spans that received a free since they filled up are queued.
+            // One completely free span is kept in reserve, the rest go back to the heap.
+            uint64_t spare = 0;
+            uint64_t release = 0;
+            for (uint64_t span_offset; (span_offset = PopPartial(mag)) != 0;) {
+                SpanHeader* span = GetPtr<SpanHeader>(span_offset);
+                CollectRemote(span);
+                if (span->live == 0) {
+                    if (spare == 0) {
+                        spare = span_offset;
+                    } else {
+                        span->next_span = release;
+                        release = span_offset;
+                    }
+                    continue;
+                }
+
+                if (spare != 0) {
+                    GetPtr<SpanHeader>(spare)->next_span = mag.partial;
+                    mag.partial = spare;
                 }
+                if (release != 0) ReleaseSpans(release);
+                mag.current_span = span_offset;
+                return PopFromSpan(span);
+            }
+            if (release != 0) ReleaseSpans(release);
+
+            if (spare != 0) {
+                ResetSpan(spare, slot, size_class);
+                mag.current_span = spare;
+                return PopFromSpan(GetPtr<SpanHeader>(spare));
             }
 
-            // If we didn't Coalesce Left, we must add 'header' to the free list
-            InsertHead(block_offset);
+            // 3. Refill: carve a fresh span from the large-object heap
+            uint64_t span_offset;
+            {
+                BackoffLockGuard guard(m_sb->lock);
+                span_offset = AllocateAlignedLocked(SPAN_SIZE, SPAN_SIZE);
+                if (span_offset == 0) return 0;
+
+                uint64_t chunk = (span_offset - m_span_origin) / SPAN_SIZE;
+                m_span_map[chunk / 64].fetch_or(1ULL << (chunk % 64), std::memory_order_release);
+                Bump(m_sb->span_count, 1);
+            }
+
+            new (GetPtr<SpanHeader>(span_offset)) SpanHeader{};
+            ResetSpan(span_offset, slot, size_class);
+            mag.current_span = span_offset;
+            return PopFromSpan(GetPtr<SpanHeader>(span_offset));
         }
-        
+
+        void FreeSmall(uint64_t offset) {
+            uint64_t span_offset = SpanOf(offset);
+            SpanHeader* span = GetPtr<SpanHeader>(span_offset);
+            uint64_t* link = GetPtr<uint64_t>(offset);
+
+            // Counted against the freeing thread's slot
+            uint32_t slot = ThreadSlot();
+            uint32_t object_size = SIZE_CLASSES[span->size_class];
+            if (slot < MAX_THREAD_SLOTS) {
+                SlotCounters& counters = m_sb->thread_caches[slot].counters;
+                Bump(counters.frees, 1);
+                Bump(counters.free_bytes, object_size);
+            } else {
+                m_sb->unslotted_frees.fetch_add(1, std::memory_order_relaxed);
+                m_sb->unslotted_free_bytes.fetch_add(object_size, std::memory_order_relaxed);
+            }
+
+            Magazine& mag = m_sb->thread_caches[span->owner_slot].classes[span->size_class];
+
+            // Owner: plain intrusive push; a full span goes back on the partial list
+            if (span->owner_slot == slot) {
+                *link = span->local_free;
+                span->local_free = offset;
+                --span->live;
+                if (span->listed.load(std::memory_order_relaxed) == 0 &&
+                    span->listed.exchange(1, std::memory_order_relaxed) == 0) {
+                    span->next_span = mag.partial;
+                    mag.partial = span_offset;
+                }
+                return;
+            }
+
+            // Remote: lock-free push; the owner drains the whole list with one exchange
+            uint64_t head = span->remote_free.load(std::memory_order_relaxed);
+            do {
+                *link = head;
+            } while (!span->remote_free.compare_exchange_weak(head, offset,
+                                                              std::memory_order_seq_cst,
+                                                              std::memory_order_relaxed));
+
+            // First free into a full span: queue it for the owner (single-consumer stack)
+            if (span->listed.load(std::memory_order_seq_cst) == 0 &&
+                span->listed.exchange(1, std::memory_order_seq_cst) == 0) {
+                uint64_t top = mag.remote_partial.load(std::memory_order_relaxed);
+                do {
+                    span->next_span = top;
+                } while (!mag.remote_partial.compare_exchange_weak(top, span_offset,
+                                                                   std::memory_order_release,
+                                                                   std::memory_order_relaxed));
+            }
+
+            // Last touch of the span: once the owner counts this free it may release it
+            span->remote_frees.fetch_add(1, std::memory_order_release);
+        }
+
     private:
         char* m_base;
-        size_t m_total_size;
+        size_t m_total_size;    // Bytes formatted up front
+        size_t m_reserve_size;  // Bytes the heap may grow into
         uint64_t m_base_offset; // Virtual offset where heap starts
         
-        uint64_t m_free_list_head_offset;
-        uint64_t m_first_block_offset;
+        BlockLayout m_layout;
+        size_t m_header_size = CACHELINE_HEADER_SIZE;
+        size_t m_granule = ALIGNMENT;      // Payload alignment and block size unit
+        size_t m_min_block = 0;            // Smallest block that can stand alone when free
 
-        Spinlock m_lock;
+        // TLSF index over free blocks (offsets; 0 implies null in our offset-based system)
+        static constexpr uint32_t TLSF_SL_LOG2 = 4;
+        static constexpr uint32_t TLSF_SL_COUNT = 1U << TLSF_SL_LOG2;
+        static constexpr uint32_t TLSF_FL_COUNT = 48 - (TLSF_SL_LOG2 + 4) + 2; // Up to 256 TB, 16-byte granule
 
-        template<typename T>
-        T* GetPtr(uint64_t offset) {
-            return reinterpret_cast<T*>(m_base + (offset - m_base_offset));
-        }
+        uint32_t m_tlsf_fl_shift = 0;      // First level starts at granule * TLSF_SL_COUNT
+        uint64_t m_tlsf_small_block = 0;
+
+        // Minimum step when the heap grows into its reserve
+        static constexpr size_t HEAP_GROW_STEP = 2 * 1024 * 1024;
+
+        // Everything needed to resume the heap, stored at the start of the region.
+        // All links are offsets, so the superblock stays valid wherever the region maps.
+        struct alignas(ALIGNMENT) Superblock {
+            uint64_t magic;
+            uint32_t version;
+            BlockLayout layout;
+            uint64_t base_offset;
+            uint64_t reserve_size;
+            uint64_t reserve_end;         // Heap may grow up to here
+            uint64_t first_block_offset;
+            uint64_t heap_end;            // One past the last block (atomic_ref outside the lock)
+            uint64_t end_prev_free;       // PREV_FREE bit of the (virtual) block at heap_end
+
+            std::atomic<uint64_t> roots[MAX_ROOTS];
+
+            uint64_t fl_bitmap;
+            uint32_t sl_bitmap[TLSF_FL_COUNT];
+            uint64_t free_heads[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+            BackoffLock lock;
+
+            // Large-object counters (written under lock, read lock-free by GetStats)
+            std::atomic<uint64_t> large_allocs;
+            std::atomic<uint64_t> large_frees;
+            std::atomic<uint64_t> large_in_use;
+            std::atomic<uint64_t> span_count;
+            std::atomic<uint64_t> failed_allocs;
+            std::atomic<uint64_t> unslotted_frees;      // Small frees from threads without a slot
+            std::atomic<uint64_t> unslotted_free_bytes;
+            std::atomic<uint64_t> grows;
+
+            // Magazines survive a reopen; a thread that later claims the slot inherits them
+            ThreadCache thread_caches[MAX_THREAD_SLOTS];
+        };
+
+        // Region offsets (from m_base) of the superblock, span map and first block
+        size_t m_superblock_adjust = 0;
+        size_t m_span_map_adjust = 0;
+        size_t m_first_block_adjust = 0;
+
+        Superblock* m_sb = nullptr;
+        bool m_reopened = false;
+
+        // Small-object tier state (the span map lives in the region, after the superblock)
+        uint64_t m_span_origin = 0; // m_base_offset rounded down to SPAN_SIZE
+        size_t m_span_chunks = 0;
+        std::atomic<uint64_t>* m_span_map = nullptr;
 
         template<typename T>
         T* GetPayload(BlockHeader* header) {
-            return reinterpret_cast<T*>(reinterpret_cast<char*>(header) + sizeof(BlockHeader));
+            return reinterpret_cast<T*>(reinterpret_cast<char*>(header) + m_header_size);
         }
 
         BlockFooter* GetFooter(BlockHeader* header) {
@@ -370,34 +1343,78 @@ namespace Cognitron::Core {
             );
         }
 
+        // Compact used blocks have no footer: their last 8 bytes belong to the payload.
         void UpdateFooter(BlockHeader* header) {
+            if (m_layout == BlockLayout::Compact && !header->IsFree()) return;
             BlockFooter* footer = GetFooter(header);
             footer->size_and_state = header->size_and_state;
         }
 
-        void InsertHead(uint64_t offset) {
+        // Keeps the right neighbour's PREV_FREE bit in sync with this block's state
+        void SetNextPrevFree(uint64_t block_offset, uint64_t block_size, bool free) {
+            uint64_t next_offset = block_offset + block_size;
+            if (next_offset < m_sb->heap_end) {
+                GetPtr<BlockHeader>(next_offset)->SetPrevFree(free);
+            } else {
+                m_sb->end_prev_free = free; // Read by GrowLocked
+            }
+        }
+
+        // --- TLSF Index ---
+        //
+        // First level: power-of-two size range. Second level: TLSF_SL_COUNT linear
+        // subdivisions of that range. One bit per non-empty list in each level, so
+        // finding a fitting list is two find-first-set operations.
+
+        void MapSize(uint64_t size, uint32_t& fl, uint32_t& sl) const {
+            if (size < m_tlsf_small_block) {
+                fl = 0;
+                sl = static_cast<uint32_t>(size / m_granule);
+            } else {
+                uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(size));
+                fl = msb - (m_tlsf_fl_shift - 1);
+                sl = static_cast<uint32_t>(size >> (msb - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+            }
+        }
+
+        // Index of a free block: the list its exact size belongs to
+        void InsertFree(uint64_t offset) {
             BlockHeader* header = GetPtr<BlockHeader>(offset);
             FreeNode* node = GetPayload<FreeNode>(header);
+
+            uint32_t fl, sl;
+            MapSize(header->GetSize(), fl, sl);
+            uint64_t& head = m_sb->free_heads[fl][sl];
             
-            node->next_offset = m_free_list_head_offset;
+            node->next_offset = head;
             node->prev_offset = 0;
 
-            if (m_free_list_head_offset != 0) {
-                 BlockHeader* old_head = GetPtr<BlockHeader>(m_free_list_head_offset);
+            if (head != 0) {
+                 BlockHeader* old_head = GetPtr<BlockHeader>(head);
                  GetPayload<FreeNode>(old_head)->prev_offset = offset;
             }
-            m_free_list_head_offset = offset;
+            head = offset;
+
+            m_sb->fl_bitmap |= (1ULL << fl);
+            m_sb->sl_bitmap[fl] |= (1U << sl);
         }
 
         void RemoveFromFreeList(uint64_t offset) {
            BlockHeader* header = GetPtr<BlockHeader>(offset);
            FreeNode* node = GetPayload<FreeNode>(header);
 
+           uint32_t fl, sl;
+           MapSize(header->GetSize(), fl, sl);
+
            if (node->prev_offset != 0) {
                BlockHeader* prev = GetPtr<BlockHeader>(node->prev_offset);
                GetPayload<FreeNode>(prev)->next_offset = node->next_offset;
            } else {
-               m_free_list_head_offset = node->next_offset;
+               m_sb->free_heads[fl][sl] = node->next_offset;
+               if (node->next_offset == 0) {
+                   m_sb->sl_bitmap[fl] &= ~(1U << sl);
+                   if (m_sb->sl_bitmap[fl] == 0) m_sb->fl_bitmap &= ~(1ULL << fl);
+               }
            }
 
            if (node->next_offset != 0) {
@@ -405,6 +1422,29 @@ namespace Cognitron::Core {
                GetPayload<FreeNode>(next)->prev_offset = node->prev_offset;
            }
         }
+
+        // Head of a list whose every block is >= size, or 0. Rounding the request up to
+        // the next list boundary is what makes the first block of the list a fit.
+        uint64_t FindFreeBlock(uint64_t size) const {
+            if (size >= m_tlsf_small_block) {
+                uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(size));
+                size += (1ULL << (msb - TLSF_SL_LOG2)) - 1;
+            }
+
+            uint32_t fl, sl;
+            MapSize(size, fl, sl);
+            if (fl >= TLSF_FL_COUNT) return 0;
+
+            uint32_t sl_map = m_sb->sl_bitmap[fl] & (~0U << sl);
+            if (sl_map == 0) {
+                uint64_t fl_map = (fl + 1 < 64) ? (m_sb->fl_bitmap & (~0ULL << (fl + 1))) : 0;
+                if (fl_map == 0) return 0;
+                fl = static_cast<uint32_t>(__builtin_ctzll(fl_map));
+                sl_map = m_sb->sl_bitmap[fl];
+            }
+            sl = static_cast<uint32_t>(__builtin_ctz(sl_map));
+            return m_sb->free_heads[fl][sl];
+        }
     };
 
 } // namespace Cognitron::Core
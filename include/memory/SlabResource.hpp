@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "memory/SlabAllocator.hpp"
+
+namespace Cognitron::Core {
+
+    /**
+     *  STANDARD LIBRARY BRIDGES
+     *  ========================
+     *
+     *  SlabAllocator hands out offsets; the standard containers want pointers.
+     *
+     *  SlabMemoryResource   std::pmr::memory_resource over a SlabAllocator. Use it for
+     *                       long-lived containers that should sit in ghost memory.
+     *  SlabStlAllocator<T>  Typed allocator for non-pmr containers
+     *                       (std::vector<T, SlabStlAllocator<T>>).
+     *  BatchArena           Monotonic bump arena with retained chunks. Everything
+     *                       allocated during a batch is dropped by one Reset(), and
+     *                       the next batch reuses the same chunks without touching
+     *                       the upstream allocator.
+     */
+
+    class SlabMemoryResource : public std::pmr::memory_resource {
+    public:
+        explicit SlabMemoryResource(SlabAllocator& allocator) : m_allocator(allocator) {}
+
+        SlabAllocator& allocator() const { return m_allocator; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if (bytes == 0) bytes = 1;
+            size_t align = alignment > m_allocator.NaturalAlignment() ? alignment : 0;
+            uint64_t offset = m_allocator.Allocate(bytes, align);
+            if (offset == 0) throw std::bad_alloc(); // memory_resource contract
+            return m_allocator.GetPtr<void>(offset);
+        }
+
+        void do_deallocate(void* ptr, size_t bytes, size_t) override {
+            if (ptr) m_allocator.Free(m_allocator.GetOffset(ptr), bytes);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            auto* slab = dynamic_cast<const SlabMemoryResource*>(&other);
+            return slab && &slab->m_allocator == &m_allocator;
+        }
+
+        SlabAllocator& m_allocator;
+    };
+
+    template<typename T>
+    class SlabStlAllocator {
+    public:
+        using value_type = T;
+
+        explicit SlabStlAllocator(SlabAllocator& allocator) noexcept : m_allocator(&allocator) {}
+
+        template<typename U>
+        SlabStlAllocator(const SlabStlAllocator<U>& other) noexcept : m_allocator(other.allocator()) {}
+
+        T* allocate(size_t n) {
+            if (n > static_cast<size_t>(-1) / sizeof(T)) throw std::bad_array_new_length();
+            size_t align = alignof(T) > m_allocator->NaturalAlignment() ? alignof(T) : 0;
+            uint64_t offset = m_allocator->Allocate(n * sizeof(T), align);
+            if (offset == 0) throw std::bad_alloc();
+            return m_allocator->GetPtr<T>(offset);
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept {
+            if (ptr) m_allocator->Free(m_allocator->GetOffset(ptr), n * sizeof(T));
+        }
+
+        SlabAllocator* allocator() const noexcept { return m_allocator; }
+
+        template<typename U>
+        bool operator==(const SlabStlAllocator<U>& other) const noexcept {
+            return m_allocator == other.allocator();
+        }
+
+    private:
+        SlabAllocator* m_allocator;
+    };
+
+    class BatchArena : public std::pmr::memory_resource {
+    public:
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        explicit BatchArena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(),
+                            size_t initial_chunk = DEFAULT_CHUNK_SIZE)
+            : m_upstream(upstream), m_next_chunk_size(initial_chunk) {}
+
+        ~BatchArena() override {
+            for (const Chunk& chunk : m_chunks) {
+                m_upstream->deallocate(chunk.begin, chunk.size, alignof(std::max_align_t));
+            }
+        }
+
+        BatchArena(const BatchArena&) = delete;
+        BatchArena& operator=(const BatchArena&) = delete;
+
+        // Drops everything allocated since the last reset. Chunks are kept, so a
+        // steady-state batch allocates nothing upstream.
+        void Reset() noexcept {
+            m_current = 0;
+            if (!m_chunks.empty()) {
+                m_cursor = m_chunks[0].begin;
+                m_limit = m_chunks[0].begin + m_chunks[0].size;
+            }
+            m_used = 0;
+        }
+
+        size_t BytesUsed() const { return m_used; }
+        size_t BytesReserved() const {
+            size_t total = 0;
+            for (const Chunk& chunk : m_chunks) total += chunk.size;
+            return total;
+        }
+
+    private:
+        struct Chunk {
+            char* begin;
+            size_t size;
+        };
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            for (;;) {
+                uintptr_t aligned = (reinterpret_cast<uintptr_t>(m_cursor) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+                if (m_cursor && aligned + bytes <= reinterpret_cast<uintptr_t>(m_limit)) {
+                    m_used += aligned + bytes - reinterpret_cast<uintptr_t>(m_cursor);
+                    m_cursor = reinterpret_cast<char*>(aligned + bytes);
+                    return reinterpret_cast<void*>(aligned);
+                }
+                NextChunk(bytes + alignment);
+            }
+        }
+
+        // Arena memory is only reclaimed by Reset()
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        // Moves to the next retained chunk that fits, or grows the arena
+        void NextChunk(size_t min_bytes) {
+            while (m_current + 1 < m_chunks.size()) {
+                const Chunk& chunk = m_chunks[++m_current];
+                if (chunk.size >= min_bytes) {
+                    m_cursor = chunk.begin;
+                    m_limit = chunk.begin + chunk.size;
+                    return;
+                }
+            }
+
+            size_t size = m_next_chunk_size;
+            while (size < min_bytes) size *= 2;
+            m_next_chunk_size = size * 2;
+
+            char* begin = static_cast<char*>(m_upstream->allocate(size, alignof(std::max_align_t)));
+            m_chunks.push_back(Chunk{begin, size});
+            m_current = m_chunks.size() - 1;
+            m_cursor = begin;
+            m_limit = begin + size;
+        }
+
+        std::pmr::memory_resource* m_upstream;
+        std::vector<Chunk> m_chunks;
+        size_t m_current = 0;
+        size_t m_next_chunk_size;
+        size_t m_used = 0;
+        char* m_cursor = nullptr;
+        char* m_limit = nullptr;
+    };
+
+} // namespace Cognitron::Core
@@ -4,6 +4,10 @@
 #include <string>
 #include <atomic>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <cstdint>
 #include <expected> // C++23
 #include <system_error>
@@ -17,7 +21,8 @@ namespace Hyperion::Core {
         ThreadSpawnFailed,
         MemoryReservationFailed,
         InvalidAccess,
-        OperatingSystemError
+        OperatingSystemError,
+        CheckpointInProgress
     };
 
     struct MemoryHeader {
@@ -26,6 +31,15 @@ namespace Hyperion::Core {
         uint64_t head_offset;
     };
 
+    // On-disk prefix of a checkpoint image. Page i of the captured range is stored at
+    // file offset page_size * (1 + i); pages that were never committed are left as holes.
+    struct CheckpointHeader {
+        uint64_t magic;
+        uint64_t page_size;
+        uint64_t region_offset; // Ghost offset of the first captured byte
+        uint64_t region_length; // Captured bytes (page multiple)
+    };
+
     /**
      * @brief The MemoryManager manages a massive virtual memory space (1 TB).
      * It uses POSIX Signal Handling (SIGSEGV/SIGBUS) to lazy-load pages.
@@ -50,8 +64,26 @@ namespace Hyperion::Core {
         
         void run_self_test();
 
+        // Asynchronous read-ahead. Queues [offset, offset + len) for the prefetch worker,
+        // which commits and populates the pages so the next sequential access does not
+        // take the SIGSEGV/SIGBUS round-trip. Never blocks; requests beyond the queue
+        // depth are dropped (prefetching is only a hint).
+        void prefetch(size_t offset, size_t len);
+
         size_t get_page_fault_count() const { return m_fault_count.load(std::memory_order_relaxed); }
         size_t get_resident_pages() const { return m_resident_pages.load(std::memory_order_relaxed); }
+        size_t get_prefetched_pages() const { return m_prefetched_pages.load(std::memory_order_relaxed); }
+
+        // Fork-free copy-on-write checkpoint of [offset, offset + length) to 'path'.
+        // The range is write-protected in place; a background writer streams pages to
+        // the image while the trap copies any page out just before its first write.
+        // length == 0 captures everything up to the current vector log head.
+        [[nodiscard]] std::expected<void, RuntimeError> begin_checkpoint(const std::string& path,
+                                                                         size_t offset = 0,
+                                                                         size_t length = 0);
+        bool checkpoint_active() const { return m_checkpoint_active.load(std::memory_order_acquire); }
+        void wait_for_checkpoint();
+        size_t get_checkpoint_cow_faults() const { return m_cow_faults.load(std::memory_order_relaxed); }
 
         // Helper for the static signal handler
         void* get_base_addr() const { return m_base_addr; }
@@ -64,11 +96,66 @@ namespace Hyperion::Core {
         std::expected<void, RuntimeError> install_signal_handlers();
         void initialize_header();
 
+        void prefetch_worker(std::stop_token stop);
+        void warm_range(uintptr_t begin, uintptr_t end);
+
+        struct PrefetchRequest {
+            size_t offset;
+            size_t len;
+        };
+
+        static constexpr size_t PREFETCH_QUEUE_DEPTH = 64;
+        static constexpr uint64_t CHECKPOINT_MAGIC = 0xC06DC4EC4B01E7ULL;
+
+        // Per-page checkpoint state machine: PENDING -> COPYING -> SAVED.
+        // Whoever wins the PENDING->COPYING CAS (writer thread or trap) copies the page.
+        enum : uint8_t { PAGE_PENDING = 0, PAGE_COPYING = 1, PAGE_SAVED = 2 };
+
+        bool handle_checkpoint_fault(uintptr_t page_addr);
+        bool unprotect_checkpoint_page(uintptr_t page_addr, size_t index);
+        void restore_checkpoint_protection();
+        void save_checkpoint_page(size_t index);
+        void checkpoint_writer();
+
     private:
         void* m_base_addr = nullptr;
         std::atomic<bool> m_running = false;
         std::atomic<size_t> m_fault_count = 0;
         std::atomic<size_t> m_resident_pages = 0;
+        std::atomic<size_t> m_prefetched_pages = 0;
+
+        // Read-ahead worker state. The queue is touched only by callers of prefetch()
+        // and the worker thread, never by the signal handler.
+        std::mutex m_prefetch_mutex;
+        std::condition_variable_any m_prefetch_cv;
+        std::deque<PrefetchRequest> m_prefetch_queue;
+        std::jthread m_prefetch_thread;
+
+        // Serialises bulk protection changes (prefetch commits vs. checkpoint arming)
+        std::mutex m_protect_mutex;
+
+        // Checkpoint state. Read from the signal handler, so everything it touches is
+        // either a lock-free atomic or immutable while m_checkpoint_active is set.
+        std::atomic<bool> m_checkpoint_active = false;
+        // Set once the arming mprotect is done; copy-on-write traps wait for it
+        std::atomic<bool> m_checkpoint_armed = false;
+        // Traps in flight, by path: committing a page (or still deciding), and on the
+        // checkpoint path. begin_checkpoint waits for both before it replaces the state
+        // below, and for commits again after it raises the flag.
+        std::atomic<size_t> m_commit_traps = 0;
+        std::atomic<size_t> m_checkpoint_traps = 0;
+        std::atomic<size_t> m_cow_faults = 0;
+        std::atomic<bool> m_checkpoint_io_error = false;
+        int m_checkpoint_fd = -1;
+        size_t m_page_size = 0;
+        uintptr_t m_checkpoint_begin = 0;
+        uintptr_t m_checkpoint_end = 0;
+        std::unique_ptr<std::atomic<uint8_t>[]> m_checkpoint_pages;
+        // 1 for pages that were not resident when the checkpoint was armed (never committed
+        // by the ghost trap): they go back to PROT_NONE once saved, and whoever first makes
+        // one writable again clears the flag and accounts for the commit.
+        std::unique_ptr<std::atomic<uint8_t>[]> m_checkpoint_uncommitted;
+        std::jthread m_checkpoint_thread;
     };
 
 }
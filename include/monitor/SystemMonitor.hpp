@@ -48,6 +48,9 @@ namespace Hyperion::TUI {
         void set_header_info(const std::string& info);
         void update_status_stats(const std::string& stats);
         void update_ghost_stats(size_t faults, size_t resident);
+        void update_heap_stats(size_t in_use, size_t free_bytes, size_t largest_free,
+                               double fragmentation, size_t lock_contended, size_t lock_max_wait_ns,
+                               bool tags_ok);
         void update_simd_lanes(const float* lanes);
         void update_memory_view(const void* ptr, size_t size);
         void update_input_text(const std::string& text);
@@ -83,6 +86,16 @@ namespace Hyperion::TUI {
         
         size_t m_page_faults = 0;
         size_t m_resident_pages = 0;
+
+        // Document heap (SlabAllocator) snapshot; m_heap_valid is false until the first report
+        bool m_heap_valid = false;
+        bool m_heap_tags_ok = true;
+        size_t m_heap_in_use = 0;
+        size_t m_heap_free = 0;
+        size_t m_heap_largest_free = 0;
+        double m_heap_fragmentation = 0.0;
+        size_t m_heap_lock_contended = 0;
+        size_t m_heap_lock_max_wait_ns = 0;
         
         std::atomic<int> m_flash_timer{0};
 
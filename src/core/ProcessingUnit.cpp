@@ -5,6 +5,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <cstdio>
 #include <memory>
 #include <array>
@@ -13,9 +14,17 @@
 #include <vector>
 #include <cstdlib>
 #include <cstring>
+#include <span>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <ranges>
 
 #include "mm/MemoryManager.hpp"
 #include "core/JITAssembler.hpp"
+#include "kernel/Scheduler.hpp"
+#include "math/Math.hpp"
+#include "core/TokenScanner.hpp"
 
 #include <cstring>
 
@@ -26,17 +35,136 @@ namespace Hyperion {
         for (int i = 1; i < argc; ++i) {
             if (std::strcmp(argv[i], "--reset") == 0) {
                 config.reset_db = true;
+            } else if (std::strcmp(argv[i], "--bench") == 0) {
+                config.run_benchmark = true;
             } else if (std::strcmp(argv[i], "--status") == 0) {
                 config.show_status = true;
+            } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+                config.analysis_workers = std::strtoull(argv[++i], nullptr, 10);
+            } else if (std::strcmp(argv[i], "--queue-capacity") == 0 && i + 1 < argc) {
+                size_t capacity = std::strtoull(argv[++i], nullptr, 10);
+                if (capacity >= 2) {
+                    config.queue_capacity = capacity;
+                } else {
+                    std::cerr << "WARN: --queue-capacity needs a value >= 2, keeping " << config.queue_capacity << std::endl;
+                }
+            } else if (std::strcmp(argv[i], "--overflow") == 0 && i + 1 < argc) {
+                const char* policy = argv[++i];
+                if (std::strcmp(policy, "block") == 0) {
+                    config.overflow_policy = OverflowPolicy::Block;
+                } else if (std::strcmp(policy, "spill") == 0) {
+                    config.overflow_policy = OverflowPolicy::Spill;
+                } else if (std::strcmp(policy, "drop") == 0) {
+                    config.overflow_policy = OverflowPolicy::Drop;
+                } else {
+                    std::cerr << "WARN: unknown --overflow policy '" << policy << "' (block|spill|drop), using spill" << std::endl;
+                }
+            } else if (std::strcmp(argv[i], "--dim") == 0 && i + 1 < argc) {
+                size_t dim = std::strtoull(argv[++i], nullptr, 10);
+                if (dim >= 64 && dim <= 4096 && dim % 64 == 0) {
+                    config.vector_dim = dim;
+                } else {
+                    std::cerr << "WARN: --dim needs a multiple of 64 in [64, 4096], keeping " << config.vector_dim << std::endl;
+                }
+            } else if (std::strcmp(argv[i], "--codec") == 0 && i + 1 < argc) {
+                const char* name = argv[++i];
+                if (auto codec = Math::ParseCodec(name)) {
+                    config.codec = *codec;
+                } else {
+                    std::cerr << "WARN: unknown --codec '" << name << "' (sq8|sq4|binary|pq), using sq8" << std::endl;
+                }
+            } else if (std::strcmp(argv[i], "--pq-subspaces") == 0 && i + 1 < argc) {
+                config.pq_subspaces = std::strtoull(argv[++i], nullptr, 10);
+            } else if (std::strcmp(argv[i], "--hash-seed") == 0 && i + 1 < argc) {
+                config.feature_seed = std::strtoull(argv[++i], nullptr, 0);
+            } else if (std::strcmp(argv[i], "--idf") == 0) {
+                config.idf_weighting = true;
+            } else if (std::strcmp(argv[i], "--ngrams") == 0 && i + 1 < argc) {
+                size_t order = std::strtoull(argv[++i], nullptr, 10);
+                if (order >= 1 && order <= MAX_NGRAM) {
+                    config.word_ngrams = order;
+                } else {
+                    std::cerr << "WARN: --ngrams needs a value in [1, " << MAX_NGRAM << "], keeping " << config.word_ngrams << std::endl;
+                }
+            } else if (std::strcmp(argv[i], "--shingles") == 0 && i + 1 < argc) {
+                size_t width = std::strtoull(argv[++i], nullptr, 10);
+                if (width == 0 || (width >= 2 && width <= MAX_SHINGLE)) {
+                    config.char_shingles = width;
+                } else {
+                    std::cerr << "WARN: --shingles needs 0 or a value in [2, " << MAX_SHINGLE << "], keeping " << config.char_shingles << std::endl;
+                }
+            } else if (std::strcmp(argv[i], "--vocab") == 0 && i + 1 < argc) {
+                config.vocab_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--codebook") == 0 && i + 1 < argc) {
+                config.codebook_path = argv[++i];
             }
         }
+
+        // Subspaces must split the vector evenly; the default gives 8 dimensions each
+        if (config.pq_subspaces != 0 &&
+            (config.vector_dim % config.pq_subspaces != 0 || config.pq_subspaces > config.vector_dim)) {
+            std::cerr << "WARN: --pq-subspaces must divide --dim, using dim / 8" << std::endl;
+            config.pq_subspaces = 0;
+        }
+        if (config.pq_subspaces == 0) config.pq_subspaces = config.vector_dim / 8;
         return config;
     }
 
+    // Ghost window owned by the document heap: far above the vector log (which grows
+    // from offset 0) and clear of the 512 GB self-test probe.
+    // The heap formats DOC_HEAP_INITIAL bytes and grows on demand up to DOC_HEAP_RESERVE.
+    static constexpr size_t DOC_HEAP_OFFSET = 256ULL * 1024 * 1024 * 1024;
+    static constexpr size_t DOC_HEAP_INITIAL = 64ULL * 1024 * 1024;
+    static constexpr size_t DOC_HEAP_RESERVE = 64ULL * 1024 * 1024 * 1024;
+
+    // First per-document arena chunk; typical pastes fit, larger ones add chunks once
+    static constexpr size_t DOC_ARENA_CHUNK = 256 * 1024;
+
+    // Documents an analysis worker claims from its input queue per pass
+    static constexpr size_t DRAIN_BATCH = 16;
+
+    // Upper bound on analysis shards (each owns a thread, two rings and an arena)
+    static constexpr size_t MAX_ANALYSIS_WORKERS = 16;
+
+    // Prefix of the --codebook file; dim * PQ_CENTROIDS native floats follow
+    struct PQCodebookHeader {
+        uint32_t magic;
+        uint32_t dim;
+        uint32_t subspaces;
+        uint32_t reserved;
+    };
+    static constexpr uint32_t PQ_CODEBOOK_MAGIC = 0x50514342; // "PQCB"
+
+    // Header of a spilled document in the ghost heap; the text follows it
+    struct SpillRecord {
+        uint64_t next;   // Heap offset of the next spilled document (0 = last)
+        uint64_t length;
+    };
+
+    // Frames between heap walks fed to the status bar (~0.5 s at 60 Hz)
+    static constexpr int HEAP_REPORT_INTERVAL = 30;
+
     // --- Engine Implementation ---
 
+    ProcessingUnit::AnalysisShard::AnalysisShard(size_t index, size_t capacity, ConcurrentVocabulary& vocabulary,
+                                                 Cognitron::Core::SlabMemoryResource* heap)
+        : index(index), input(capacity), output(capacity), tokenizer(vocabulary), arena(heap, DOC_ARENA_CHUNK) {}
+
+    // The previous run's vocabulary, unless --reset or it was hashed with another --hash-seed
+    // (its ids would then not match the features). Either way the file is replaced on shutdown.
+    static std::unique_ptr<MappedVocabulary> OpenSavedVocabulary(const ProcessingUnitConfig& config) {
+        if (config.reset_db) return nullptr;
+        auto saved = MappedVocabulary::Open(config.vocab_path);
+        if (saved && saved->Seed() != config.feature_seed) {
+            std::cerr << "WARN: vocabulary '" << config.vocab_path << "' was saved with --hash-seed "
+                      << saved->Seed() << ", starting a new one" << std::endl;
+            return nullptr;
+        }
+        return saved;
+    }
+
     ProcessingUnit::ProcessingUnit(int argc, char* argv[]) 
-        : m_config(ParseEngineCLI(argc, argv)) { 
+        : m_config(ParseEngineCLI(argc, argv)), m_saved_vocabulary(OpenSavedVocabulary(m_config)) { 
         
         // Bootstrapping the Ghost Engine singleton establishes the 1TB exception handler trap 
         // *before* any allocations occur, ensuring safe memory layout.
@@ -45,6 +173,34 @@ namespace Hyperion {
             std::cerr << "FATAL: Ghost Engine boot failed: " << (int)ghost_res.error() << std::endl;
             exit(1);
         }
+
+        // Pages are committed lazily by the ghost trap as the heap touches them. The window
+        // is anonymous memory, so every run formats a fresh heap.
+        char* ghost_base = static_cast<char*>(Core::MemoryManager::instance().get_base_addr());
+        m_heap = std::make_unique<Cognitron::Core::SlabAllocator>(ghost_base + DOC_HEAP_OFFSET,
+                                                                 DOC_HEAP_INITIAL, DOC_HEAP_OFFSET,
+                                                                 Cognitron::Core::BlockLayout::CacheLine,
+                                                                 DOC_HEAP_RESERVE);
+        m_heap_resource = std::make_unique<Cognitron::Core::SlabMemoryResource>(*m_heap);
+
+        // Document frequencies go with the saved ids; the terms themselves stay in the mapping
+        if (m_saved_vocabulary) {
+            m_idf_manager.SetDocFreqs(m_saved_vocabulary->DocFreqs(), m_saved_vocabulary->TotalDocs());
+        }
+
+        // Default: every core except the one running the scheduler/UI and the committer's
+        size_t workers = m_config.analysis_workers;
+        if (workers == 0) {
+            const unsigned cores = std::thread::hardware_concurrency();
+            workers = cores > 2 ? cores - 2 : 1;
+        }
+        workers = std::min(workers, MAX_ANALYSIS_WORKERS);
+        for (size_t i = 0; i < workers; ++i) {
+            m_shards.push_back(std::make_unique<AnalysisShard>(i, m_config.queue_capacity, m_vocabulary, m_heap_resource.get()));
+            m_shards.back()->tokenizer.SetPhraseFeatures(m_config.word_ngrams, m_config.char_shingles, m_config.feature_seed);
+        }
+
+        if (m_config.codec == Math::VectorCodec::PQ) LoadCodebook();
         
         // Allocates the executable pages (r-x) for generated traces.
         Core::JITAssembler jit;
@@ -64,7 +220,10 @@ namespace Hyperion {
         
         // The Main Thread is reserved for the TUI Render Loop to ensure 60fps smoothness.
         // Offloading analysis avoids frame stutter.
-        m_analysis_thread = std::jthread(&ProcessingUnit::AnalysisWorker, this);
+        for (auto& shard : m_shards) {
+            shard->thread = std::jthread(&ProcessingUnit::AnalysisWorker, this, std::ref(*shard));
+        }
+        m_commit_thread = std::jthread(&ProcessingUnit::CommitWorker, this);
     }
 
     void ProcessingUnit::Update() {
@@ -72,6 +231,9 @@ namespace Hyperion {
         
         auto& tui = TUI::SystemMonitor::instance();
 
+        // Keep spilled documents flowing even when no new input arrives
+        DrainSpill();
+
         // Stats Logic
         // We read from the Ghost Header directly using raw pointers.
         size_t doc_count = 0;
@@ -83,10 +245,25 @@ namespace Hyperion {
             doc_count = std::atomic_ref<uint64_t>(header->vector_count).load(std::memory_order_acquire);
         }
 
+        size_t queued = 0;
+        size_t queue_slots = 0;
+        for (const auto& shard : m_shards) {
+            queued += shard->input.size_approx();
+            queue_slots += shard->input.capacity() - 1;
+        }
+
+        // UI + analysis shards + committer
         std::stringstream stats;
         stats << "Docs: " << doc_count
-              << " | Vocab: " << m_tokenizer.VocabularySize()
-              << " | Threads: 2 [ACTIVE]";
+              << " | Vocab: " << m_vocabulary.size()
+              << " | Threads: " << (m_shards.size() + 2) << " [ACTIVE]"
+              << " | Queue: " << queued << "/" << queue_slots;
+        if (m_ingest_stats.spill_depth > 0) {
+            stats << " +" << m_ingest_stats.spill_depth << " spilled (" << (m_ingest_stats.spill_bytes >> 10) << "K)";
+        }
+        if (m_ingest_stats.dropped > 0) {
+            stats << " | DROPPED: " << m_ingest_stats.dropped;
+        }
         
         tui.update_status_stats(stats.str());
         tui.update_ghost_stats(
@@ -94,6 +271,21 @@ namespace Hyperion {
             Core::MemoryManager::instance().get_resident_pages()
         );
 
+        // The heap walk takes the allocator lock, so it runs at a fraction of the frame rate
+        if (m_heap && ++m_heap_report_tick >= HEAP_REPORT_INTERVAL) {
+            m_heap_report_tick = 0;
+            auto report = m_heap->WalkHeap();
+            tui.update_heap_stats(
+                report.stats.large_in_use_bytes + report.stats.small_in_use_bytes,
+                report.free_bytes,
+                report.largest_free,
+                report.Fragmentation(),
+                report.stats.lock_contended,
+                report.stats.lock_max_wait_ns,
+                report.Valid()
+            );
+        }
+
         // Randomly touch the Ghost Memory to verify the exception handler is alive.
         if (rand() % 10 == 0 && base) { 
             static size_t ghost_offset = 0;
@@ -133,123 +325,697 @@ namespace Hyperion {
         
         m_processing_cooldown = 20; 
 
-        // Offload large text processing to the worker thread
-        m_input_queue.push(std::string(text));
+        // Offload large text processing to the worker thread. The text is assigned into
+        // the slot's own string, so a warm queue does not allocate.
+        // Spilled documents are older, so new input only bypasses the spill when it is empty.
+        DrainSpill();
+        if (m_spill_head == 0 && Dispatch(text)) {
+            m_ingest_stats.accepted++;
+            return;
+        }
+        Overflow(text);
+    }
+
+    void ProcessingUnit::IngestBatch(std::span<const std::string_view> documents) {
+        if (documents.empty()) return;
+
+        auto& tui = TUI::SystemMonitor::instance();
+        tui.update_input_text(std::string(documents.back()));
+        tui.trigger_input_flash();
+
+        m_processing_cooldown = 20;
+
+        DrainSpill();
+        // Runs between empty documents (which Ingest skips) go out in bulk; what a run
+        // leaves over takes Ingest's path one by one, so it overflows only on a full queue
+        size_t begin = 0;
+        while (begin < documents.size()) {
+            if (documents[begin].empty()) {
+                ++begin;
+                continue;
+            }
+            size_t end = begin + 1;
+            while (end < documents.size() && !documents[end].empty()) ++end;
+            const auto run = documents.subspan(begin, end - begin);
+            begin = end;
+
+            size_t dispatched = 0;
+            if (m_spill_head == 0) {
+                dispatched = DispatchBatch(run);
+                m_ingest_stats.accepted += dispatched;
+            }
+            for (std::string_view text : run.subspan(dispatched)) {
+                if (m_spill_head == 0 && Dispatch(text)) {
+                    m_ingest_stats.accepted++;
+                } else {
+                    Overflow(text);
+                }
+            }
+        }
+    }
+
+    void ProcessingUnit::Overflow(std::string_view text) {
+        // Queue full: the workers are behind
+        switch (m_config.overflow_policy) {
+            case OverflowPolicy::Block: {
+                // Yield the fiber, not the thread: the UI fiber keeps rendering meanwhile
+                auto& scheduler = Kernel::Scheduler::Get();
+                while (m_running) {
+                    if (Dispatch(text)) {
+                        m_ingest_stats.accepted++;
+                        return;
+                    }
+                    m_ingest_stats.block_yields++;
+                    if (scheduler.IsSchedulerThread()) {
+                        scheduler.Yield();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                m_ingest_stats.dropped++; // Shutting down
+                break;
+            }
+            case OverflowPolicy::Spill:
+                if (!SpillDocument(text)) m_ingest_stats.dropped++;
+                break;
+            case OverflowPolicy::Drop:
+                m_ingest_stats.dropped++;
+                break;
+        }
+    }
+
+    bool ProcessingUnit::Dispatch(std::string_view text) {
+        if (m_shards.empty()) return false;
+
+        // Strict round robin, even when another shard has room: the committer relies on it
+        if (!m_shards[m_next_shard]->input.push(text)) return false;
+        m_next_shard = (m_next_shard + 1) % m_shards.size();
+        return true;
+    }
+
+    size_t ProcessingUnit::DispatchBatch(std::span<const std::string_view> documents) {
+        const size_t shard_count = m_shards.size();
+        if (shard_count == 0) return 0;
+
+        // Round robin means document i lands on shard (m_next_shard + i) % N. Take the
+        // longest prefix every shard has room for, so nothing jumps ahead of a document
+        // that has to overflow.
+        std::array<size_t, MAX_ANALYSIS_WORKERS> room{};
+        std::array<size_t, MAX_ANALYSIS_WORKERS> take{};
+        for (size_t k = 0; k < shard_count; ++k) room[k] = m_shards[k]->input.free_slots();
+
+        size_t accepted = 0;
+        while (accepted < documents.size()) {
+            const size_t k = (m_next_shard + accepted) % shard_count;
+            if (take[k] == room[k]) break;
+            take[k]++;
+            accepted++;
+        }
+
+        // Shard k receives documents j, j + N, j + 2N, ... of the prefix: one publish each
+        for (size_t j = 0; j < shard_count && j < accepted; ++j) {
+            const size_t k = (m_next_shard + j) % shard_count;
+            auto strided = std::views::iota(size_t{0}, take[k]) |
+                           std::views::transform([&](size_t n) { return documents[j + n * shard_count]; });
+            // Only this thread pushes, so the room counted above is still there
+            [[maybe_unused]] const size_t pushed = m_shards[k]->input.try_push_n(strided);
+            assert(pushed == take[k]);
+        }
+
+        m_next_shard = (m_next_shard + accepted) % shard_count;
+        return accepted;
+    }
+
+    bool ProcessingUnit::SpillDocument(std::string_view text) {
+        if (!m_heap) return false;
+
+        uint64_t offset = m_heap->Allocate(sizeof(SpillRecord) + text.size());
+        if (offset == 0) return false; // Reserve exhausted
+
+        auto* record = m_heap->GetPtr<SpillRecord>(offset);
+        record->next = 0;
+        record->length = text.size();
+        std::memcpy(record + 1, text.data(), text.size());
+
+        if (m_spill_tail != 0) {
+            m_heap->GetPtr<SpillRecord>(m_spill_tail)->next = offset;
+        } else {
+            m_spill_head = offset;
+        }
+        m_spill_tail = offset;
+
+        m_ingest_stats.spilled++;
+        m_ingest_stats.spill_depth++;
+        m_ingest_stats.spill_bytes += text.size();
+        return true;
+    }
+
+    void ProcessingUnit::DrainSpill() {
+        while (m_spill_head != 0) {
+            auto* record = m_heap->GetPtr<SpillRecord>(m_spill_head);
+            std::string_view text(reinterpret_cast<const char*>(record + 1), record->length);
+            if (!Dispatch(text)) break;
+
+            const uint64_t next = record->next;
+            m_ingest_stats.spill_depth--;
+            m_ingest_stats.spill_bytes -= text.size();
+            m_heap->Free(m_spill_head, sizeof(SpillRecord) + text.size());
+            m_spill_head = next;
+        }
+        if (m_spill_head == 0) m_spill_tail = 0;
     }
 
     void ProcessingUnit::Shutdown() {
         if (!m_running) return; 
         m_running = false;
+        for (auto& shard : m_shards) {
+            shard->input.wake();
+            shard->output.wake();
+        }
+
+        // Workers, committer and arenas all touch ghost memory; retire them before it is unmapped
+        for (auto& shard : m_shards) {
+            if (shard->thread.joinable()) shard->thread.join();
+        }
+        if (m_commit_thread.joinable()) m_commit_thread.join();
+        m_shards.clear();
+
+        // Workers and committer are gone, so the vocabulary and IDF counts are final
+        SaveVocabulary();
+
+        // The spill list is not persisted; return its records rather than leak them in the heap
+        while (m_spill_head != 0) {
+            auto* record = m_heap->GetPtr<SpillRecord>(m_spill_head);
+            const uint64_t next = record->next;
+            m_heap->Free(m_spill_head, sizeof(SpillRecord) + record->length);
+            m_spill_head = next;
+        }
+        m_spill_tail = 0;
         
         Core::MemoryManager::instance().shutdown();
     }
     
+    // Codec microbenchmark (--bench) on TF-shaped vectors (mostly zero buckets, small
+    // integer counts) at the configured dimension: SQ8 quantization, scalar reference vs
+    // the dispatched kernel, then size, reconstruction error and distance cost per codec.
     void ProcessingUnit::RunBenchmark() {
+        constexpr size_t SAMPLES = 1024;
+        constexpr size_t ROUNDS = 2000;
+        const size_t dim = m_config.vector_dim;
+        const size_t subspaces = m_config.pq_subspaces;
+
+        std::vector<float> vectors(SAMPLES * dim, 0.0f);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (float& v : vectors) {
+            state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+            if ((state & 7) == 0) v = static_cast<float>(1 + (state >> 8) % 12);
+        }
+        auto vec = [&](size_t i) { return &vectors[i * dim]; };
+
+        // Mean cost of body(i) over 'rounds' passes of the sample set
+        auto time_ns = [&](size_t rounds, auto&& body) {
+            float sink = 0.0f;
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t round = 0; round < rounds; ++round) {
+                for (size_t i = 0; i < SAMPLES; ++i) sink += body(i);
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            if (sink < 0.0f) std::cout << sink; // Keep the loop observable
+            return std::chrono::duration<double, std::nano>(elapsed).count() / (SAMPLES * rounds);
+        };
+
+        // 1. SQ8 quantization kernels
+        std::vector<int8_t> codes(dim);
+        std::vector<int8_t> reference(dim);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            Math::QuantizeSQ8Scalar(vec(i), reference.data(), dim);
+            Math::QuantizeSQ8(vec(i), codes.data(), dim);
+            if (reference != codes) ++mismatches;
+        }
+        const double scalar_ns = time_ns(ROUNDS, [&](size_t i) { return Math::QuantizeSQ8Scalar(vec(i), codes.data(), dim).scale; });
+        const double simd_ns = time_ns(ROUNDS, [&](size_t i) { return Math::QuantizeSQ8(vec(i), codes.data(), dim).scale; });
+
+        std::cout << "Quantize SQ8, " << dim << "-dim, " << SAMPLES * ROUNDS << " vectors\n"
+                  << "  " << std::left << std::setw(7) << "scalar" << ": " << scalar_ns << " ns/vector\n"
+                  << "  " << std::setw(7) << Math::QuantizeKernelName() << ": " << simd_ns << " ns/vector (" << scalar_ns / simd_ns << "x)\n"
+                  << "  mismatched vectors: " << mismatches << "\n";
+
+        // 2. Encode the sample set with every codec (PQ trains its codebook on it)
+        using Math::VectorCodec;
+        const size_t sq4_bytes = Math::CodeBytes(VectorCodec::SQ4, dim, subspaces);
+        const size_t bin_bytes = Math::CodeBytes(VectorCodec::Binary, dim, subspaces);
+        std::vector<int8_t> sq8(SAMPLES * dim);
+        std::vector<uint8_t> sq4(SAMPLES * sq4_bytes);
+        std::vector<uint8_t> bin(SAMPLES * bin_bytes);
+        std::vector<uint8_t> pq_codes(SAMPLES * subspaces);
+        std::vector<Math::QuantParams> sq8_params(SAMPLES), sq4_params(SAMPLES), bin_params(SAMPLES);
+
+        Math::ProductQuantizer pq(dim, subspaces);
+        pq.Train(vectors.data(), SAMPLES);
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            sq8_params[i] = Math::QuantizeSQ8(vec(i), &sq8[i * dim], dim);
+            sq4_params[i] = Math::QuantizeSQ4(vec(i), &sq4[i * sq4_bytes], dim);
+            bin_params[i] = Math::QuantizeBinary(vec(i), &bin[i * bin_bytes], dim);
+            pq.Encode(vec(i), &pq_codes[i * subspaces]);
+        }
+
+        // 3. Reconstruction error: each vector's distance to its own encoding, relative to its norm
+        std::vector<float> table(subspaces * Math::PQ_CENTROIDS);
+        double norm = 0.0, err_sq8 = 0.0, err_sq4 = 0.0, err_bin = 0.0, err_pq = 0.0;
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            const float* v = vec(i);
+            for (size_t d = 0; d < dim; ++d) norm += v[d] * v[d];
+            err_sq8 += Math::L2SqrSQ8(v, &sq8[i * dim], sq8_params[i], dim);
+            err_sq4 += Math::L2SqrSQ4(v, &sq4[i * sq4_bytes], sq4_params[i], dim);
+            for (size_t d = 0; d < dim; ++d) {
+                const bool bit = (bin[i * bin_bytes + d / 8] >> (d % 8)) & 1;
+                const float decoded = bin_params[i].bias + (bit ? bin_params[i].scale : -bin_params[i].scale);
+                err_bin += (v[d] - decoded) * (v[d] - decoded);
+            }
+            pq.ComputeDistanceTable(v, table.data());
+            err_pq += Math::PQDistance(table.data(), &pq_codes[i * subspaces], subspaces);
+        }
+
+        // 4. Distance cost: one query against every encoded vector (PQ table built once)
+        const float* query = vec(0);
+        pq.ComputeDistanceTable(query, table.data());
+        const size_t rounds = ROUNDS / 10;
+        const double ns_sq8 = time_ns(rounds, [&](size_t i) { return Math::L2SqrSQ8(query, &sq8[i * dim], sq8_params[i], dim); });
+        const double ns_sq4 = time_ns(rounds, [&](size_t i) { return Math::L2SqrSQ4(query, &sq4[i * sq4_bytes], sq4_params[i], dim); });
+        const double ns_bin = time_ns(rounds, [&](size_t i) { return static_cast<float>(Math::HammingDistance(bin.data(), &bin[i * bin_bytes], bin_bytes)); });
+        const double ns_pq = time_ns(rounds, [&](size_t i) { return Math::PQDistance(table.data(), &pq_codes[i * subspaces], subspaces); });
+
+        std::cout << "Codecs, " << dim << "-dim (pq: " << subspaces << " subspaces)\n"
+                  << "  codec   record  rel.error  ns/distance\n";
+        auto row = [&](VectorCodec codec, double err, double ns) {
+            std::cout << "  " << std::left << std::setw(8) << Math::CodecName(codec)
+                      << std::right << std::setw(6) << Math::RecordBytes(codec, dim, subspaces) << "  "
+                      << std::setw(9) << std::fixed << std::setprecision(4) << err / norm << "  "
+                      << std::setw(11) << std::setprecision(1) << ns << "\n";
+        };
+        row(VectorCodec::SQ8, err_sq8, ns_sq8);
+        row(VectorCodec::SQ4, err_sq4, ns_sq4);
+        row(VectorCodec::Binary, err_bin, ns_bin);
+        row(VectorCodec::PQ, err_pq, ns_pq);
+
+        // 5. Tokenizer throughput on large pastes: mixed-case ASCII, then multilingual UTF-8
+        static constexpr std::string_view WORDS[] = {
+            "Hyperion", "vector", "the", "Quantized", "log", "and", "throughput", "of", "SIMD", "2048", "kernel", "Token"
+        };
+        static constexpr std::string_view UTF8_WORDS[] = {
+            "Größe", "vector", "Привет", "мир", "日本語", "café", "Ωμέγα", "naïve", "data", "ＡＢＣ", "한국어", "Straße"
+        };
+        auto make_paste = [&](std::span<const std::string_view> words) {
+            std::string paste;
+            paste.reserve(16 << 20);
+            while (paste.size() < (16u << 20)) {
+                state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+                paste += words[state % words.size()];
+                paste += (state >> 8) % 8 ? " " : ".\n";
+            }
+            return paste;
+        };
+        auto gb_per_s = [&](const std::string& paste, auto&& body) {
+            const auto start = std::chrono::steady_clock::now();
+            body();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return paste.size() / elapsed.count() / 1e9;
+        };
+        auto scan_gbps = [&](const std::string& paste, size_t& token_bytes) {
+            token_bytes = 0;
+            return gb_per_s(paste, [&] {
+                TokenScanner scanner(paste);
+                std::string_view token;
+                while (scanner.Next(token)) token_bytes += token.size();
+            });
+        };
+
+        const std::string paste = make_paste(WORDS);
+        const std::string utf8_paste = make_paste(UTF8_WORDS);
+        Tokenizer tokenizer;
+        std::pmr::monotonic_buffer_resource arena;
+        size_t terms = 0, ascii_bytes = 0, utf8_bytes = 0;
+        const double ascii_scan = scan_gbps(paste, ascii_bytes);
+        const double utf8_scan = scan_gbps(utf8_paste, utf8_bytes);
+        const double tokenize_gbps = gb_per_s(paste, [&] { terms = tokenizer.Tokenize(paste, &arena).size(); });
+
+        // Same paste as 64 KB documents, with bigrams, trigrams and 5-byte shingles hashed
+        // alongside the terms (one reused hash buffer, as in a worker)
+        static constexpr size_t PHRASE_DOC = 64 * 1024;
+        Tokenizer phrase_tokenizer;
+        phrase_tokenizer.SetPhraseFeatures(3, 5, m_config.feature_seed);
+        PhraseHashes phrases;
+        phrases.reserve(PHRASE_DOC * 2);
+        size_t phrase_count = 0;
+        const double phrase_gbps = gb_per_s(paste, [&] {
+            for (size_t offset = 0; offset < paste.size(); offset += PHRASE_DOC) {
+                phrases.clear();
+                phrase_tokenizer.Tokenize(std::string_view(paste).substr(offset, PHRASE_DOC), &arena, &phrases);
+                phrase_count += phrases.size();
+            }
+        });
+
+        std::cout << "Tokenizer, " << (paste.size() >> 20) << " MB pastes (" << TokenScanner::KernelName() << ")\n"
+                  << "  scan ascii: " << std::setprecision(2) << ascii_scan << " GB/s (" << ascii_bytes << " token bytes)\n"
+                  << "  scan utf-8: " << utf8_scan << " GB/s (" << utf8_bytes << " token bytes)\n"
+                  << "  tokenize  : " << tokenize_gbps << " GB/s (" << terms << " terms)\n"
+                  << "  + phrases : " << phrase_gbps << " GB/s (" << phrase_count << " n-gram / shingle hashes)\n";
+        std::cout << std::defaultfloat << std::flush;
+    }
+
+    void ProcessingUnit::DumpHeapReport(const std::string& path) {
+        if (!m_heap) return;
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return;
+        m_heap->DumpReport(out);
     }
 
     // --- Workers ---
 
-    void ProcessingUnit::AnalysisWorker() {
-        // Consumes the Lock-Free Ring Buffer.
+    // Read-ahead granularity for the append-only vector log
+    static constexpr size_t PREFETCH_WINDOW = 2 * 1024 * 1024;
+
+    // Fixed-point unit of the vectorizer's per-bucket sums (16 fractional bits)
+    static constexpr float FEATURE_FIXED_ONE = 65536.0f;
+
+    // Adds sign * (1 + ln tf) for every distinct phrase hash (no TermID, so no IDF).
+    // A counting sort on the top bits of the hash, with about one group per hash, brings
+    // equal features together; only the rare group of two or more needs sorting. Most
+    // phrases occur once and skip the log. Several times cheaper than sorting the list.
+    static void AddPhraseFeatures(std::span<const uint64_t> phrases, int64_t* sums, size_t dim,
+                                  std::pmr::memory_resource* scratch) {
+        if (phrases.empty()) return;
+        const unsigned bits = std::bit_width(phrases.size());
+        const unsigned shift = 64 - bits;
+        const size_t groups = size_t{1} << bits;
+        auto* starts = static_cast<uint32_t*>(scratch->allocate((groups + 1) * sizeof(uint32_t), alignof(uint32_t)));
+        auto* grouped = static_cast<uint64_t*>(scratch->allocate(phrases.size() * sizeof(uint64_t), alignof(uint64_t)));
+        std::fill(starts, starts + groups + 1, uint32_t{0});
+        for (uint64_t hash : phrases) starts[(hash >> shift) + 1]++;
+        for (size_t g = 0; g < groups; ++g) starts[g + 1] += starts[g];
+        // Scatter with starts[g] as group g's cursor; afterwards starts[g] is where g ends
+        for (uint64_t hash : phrases) grouped[starts[hash >> shift]++] = hash;
+
+        constexpr auto ONCE = static_cast<int64_t>(FEATURE_FIXED_ONE); // 1 + ln 1
+        size_t begin = 0;
+        for (size_t g = 0; g < groups; ++g) {
+            const size_t end = starts[g];
+            if (end - begin > 1) std::sort(grouped + begin, grouped + end);
+            for (size_t i = begin; i < end;) {
+                size_t run = i + 1;
+                while (run < end && grouped[run] == grouped[i]) ++run;
+                const int64_t fixed = run - i == 1 ? ONCE :
+                    static_cast<int64_t>(std::lround((1.0f + std::log(static_cast<float>(run - i))) * FEATURE_FIXED_ONE));
+                const uint16_t slot = FeatureSlot(grouped[i], dim);
+                sums[SlotBucket(slot)] += SlotNegative(slot) ? -fixed : fixed;
+                i = run;
+            }
+            begin = end;
+        }
+    }
+
+    // Longest run of records the committer stages before publishing (~68 KB of 256-dim SQ8)
+    static constexpr size_t COMMIT_BATCH = 256;
+
+    void ProcessingUnit::AnalysisWorker(AnalysisShard& shard) {
+        // Consumes this shard's Lock-Free Ring Buffer. Documents are analysed in their
+        // slots and results are built in place in the output ring, so nothing is copied.
+        while (m_running) {
+            auto batch = shard.input.claim_pop(DRAIN_BATCH);
+            if (batch.empty()) {
+                // Spins briefly, then sleeps on a futex until Ingest publishes (or Shutdown)
+                shard.input.wait(m_running);
+                continue;
+            }
+
+            for (const std::string& document : batch) {
+                std::span<AnalysisResult> out = shard.output.claim_push(1);
+                while (out.empty()) {
+                    if (!m_running) return;
+                    std::this_thread::yield(); // Committer is behind
+                    out = shard.output.claim_push(1);
+                }
+                AnalyzeDocument(shard, document, out[0]);
+                shard.output.commit_push(1);
+            }
+            shard.input.commit_pop(batch.size());
+        }
+    }
+
+    void ProcessingUnit::CommitWorker() {
+        // Shards were dealt documents round-robin, so taking one result from each in turn
+        // replays ingest order: a single ordered writer for the vocabulary, IDF and log.
+        // Records are staged back to back past the log head and published in runs.
+        size_t staged = 0;
+        size_t staged_bytes = 0;
         while (m_running) {
-            auto content_opt = m_input_queue.pop();
-            if (content_opt) {
-                ProcessDocument(*content_opt);
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            AnalysisShard& shard = *m_shards[m_commit_shard];
+            auto ready = shard.output.claim_pop(1);
+            if (ready.empty()) {
+                // Caught up: publish the run before sleeping
+                if (staged > 0) {
+                    PublishRecords(staged, staged_bytes);
+                    staged = staged_bytes = 0;
+                }
+                shard.output.wait(m_running);
+                continue;
+            }
+            if (size_t bytes = CommitDocument(ready[0], staged_bytes)) {
+                staged++;
+                staged_bytes += bytes;
+            }
+            shard.output.commit_pop(1);
+            m_commit_shard = (m_commit_shard + 1) % m_shards.size();
+
+            if (staged == COMMIT_BATCH) {
+                PublishRecords(staged, staged_bytes);
+                staged = staged_bytes = 0;
             }
         }
+        if (staged > 0) PublishRecords(staged, staged_bytes);
     }
 
-    // Hashing Vectorizer Dimension
-    static constexpr size_t VECTOR_DIM = 256;
+    void ProcessingUnit::AnalyzeDocument(AnalysisShard& shard, const std::string& content, AnalysisResult& result) {
+        result.has_record = false;
+        result.terms.clear();
+
+        // Position in ingest order: documents are dealt to the shards strictly round-robin
+        const uint64_t sequence = shard.analysed++ * m_shards.size() + shard.index;
+        const size_t dim = m_config.vector_dim;
+
+        // Everything the previous document left in the arena is dead by now
+        shard.arena.Reset();
+
+        // 1. Tokenize against the shared vocabulary: known terms resolve lock-free, new ones
+        // lock only their vocabulary shard. Ids depend on which worker sees a term first; the
+        // vector does not, since it is built from the term hashes.
+        // Phrase features (--ngrams, --shingles) come out as rolling hashes in the same pass
+        PhraseHashes phrases(&shard.arena);
+        auto term_counts = shard.tokenizer.Tokenize(content, &shard.arena, &phrases);
+
+        if (term_counts.empty() && phrases.empty()) return;
 
-    void ProcessingUnit::ProcessDocument(const std::string& content) {
-        // 1. Tokenize
-        auto term_counts = m_tokenizer.Tokenize(content);
-        if (term_counts.empty()) return;
+        // 2. Vectorize (Signed Hashing Trick)
+        // One pass over the term counts: each term adds sign * (1 + ln tf) [* idf] to its
+        // bucket. Slots come from the term's hash (stored by the vocabulary), not its id.
+        //
+        // Sums are kept in fixed point (arena scratch): integer addition is exact, so the
+        // vector does not depend on term_counts' iteration order, which follows the ids.
+        // That keeps the log identical for any worker count.
+        auto* sums = static_cast<int64_t*>(shard.arena.allocate(dim * sizeof(int64_t), Cognitron::Core::ALIGNMENT));
+        std::fill(sums, sums + dim, int64_t{0});
+
+        // IDF is read live: documents still in flight are not counted, so with --idf the
+        // log depends on timing
+        const uint64_t total_docs = m_config.idf_weighting ? m_idf_manager.TotalDocs() : 0;
 
-        // 2. Vectorize (Hashing Trick)
-        // Transform sparse term counts into a dense 256-dimension float vector
-        std::vector<float> dense_vec(VECTOR_DIM, 0.0f);
         for (const auto& [term_id, count] : term_counts) {
-            // Simple hash of the term ID to a bucket
-            size_t bucket = term_id % VECTOR_DIM;
-            // Add count (simple TF)
-            dense_vec[bucket] += static_cast<float>(count);
+            float weight = 1.0f + std::log(static_cast<float>(count)); // Sublinear TF
+            if (total_docs > 0) weight *= m_idf_manager.GetIDF(term_id, total_docs);
+            const uint16_t slot = FeatureSlot(m_vocabulary.Hash(term_id), dim);
+            const auto fixed = static_cast<int64_t>(std::lround(weight * FEATURE_FIXED_ONE));
+            sums[SlotBucket(slot)] += SlotNegative(slot) ? -fixed : fixed;
+
+            result.terms.push_back(term_id);
         }
 
-        // 3. Inline Zero-Copy Quantization to Ghost Memory
-        // ------------------------------------------------
-        // Instead of allocating a temporary std::vector<int8_t>, we calculate
-        // and write directly to the persistent memory pointer.
+        AddPhraseFeatures(phrases, sums, dim, &shard.arena);
 
-        void* base = Core::MemoryManager::instance().get_base_addr();
-        if (!base) return;
+        // L2 normalize into the dense float vector, so cosine similarity is a dot product
+        // and document length drops out (a vector whose terms all cancel stays zero)
+        double norm_sq = 0.0;
+        for (size_t d = 0; d < dim; ++d) norm_sq += static_cast<double>(sums[d]) * static_cast<double>(sums[d]);
+        const double inv_norm = norm_sq > 0.0 ? 1.0 / std::sqrt(norm_sq) : 0.0;
 
-        auto* header = reinterpret_cast<Core::MemoryHeader*>(base);
-        uint64_t current_offset = header->head_offset;
-        
-        // Structure on Disk/Ghost:
-        // [Scale (float)] [Bias (float)] [Data (256 bytes)] 
-        size_t entry_size = sizeof(float) + sizeof(float) + VECTOR_DIM;
+        std::span<float> dense_vec(
+            static_cast<float*>(shard.arena.allocate(dim * sizeof(float), Cognitron::Core::ALIGNMENT)),
+            dim);
+        for (size_t d = 0; d < dim; ++d) dense_vec[d] = static_cast<float>(static_cast<double>(sums[d]) * inv_norm);
+
+        // 3. Encode into the shard's output slot
+        EncodeRecord(dense_vec, sequence, result);
+        result.has_record = true;
+    }
 
-        // Calculate destination pointer
-        char* dest = static_cast<char*>(base) + current_offset;
+    void ProcessingUnit::EncodeRecord(std::span<const float> dense_vec, uint64_t sequence, AnalysisResult& result) {
+        using Math::VectorCodec;
+        const size_t dim = dense_vec.size();
+        const size_t subspaces = m_config.pq_subspaces;
+
+        VectorCodec codec = m_config.codec;
+        const Math::ProductQuantizer* pq = nullptr;
+        if (codec == VectorCodec::PQ) {
+            // The committer trains once it has the first PQ_TRAIN_DOCS documents, all of which
+            // were analysed before this one; later documents wait for that codebook, so the
+            // switch point is fixed by ingest order, not by timing.
+            pq = m_pq_ready.load(std::memory_order_acquire);
+            while (!pq && sequence >= PQ_TRAIN_DOCS && m_running) {
+                std::this_thread::yield();
+                pq = m_pq_ready.load(std::memory_order_acquire);
+            }
+            if (!pq) codec = VectorCodec::SQ8; // Training set (or shutting down)
+        }
 
-        // A. Calculate Scalar Quantization Params (Min/Max)
-        float min_val = dense_vec[0];
-        float max_val = dense_vec[0];
-        for (float v : dense_vec) {
-            if (v < min_val) min_val = v;
-            if (v > max_val) max_val = v;
+        // The record is laid out exactly as in the vector log, so committing is one copy.
+        // Resizing the slot's buffer only allocates the first time the slot is used.
+        const size_t code_bytes = Math::CodeBytes(codec, dim, subspaces);
+        result.record.resize(Math::RecordBytes(codec, dim, subspaces));
+        char* dest = result.record.data();
+        char* codes = dest + sizeof(Math::VectorRecordHeader);
+
+        Math::QuantParams params{};
+        switch (codec) {
+            case VectorCodec::SQ8:
+                params = Math::QuantizeSQ8(dense_vec.data(), reinterpret_cast<int8_t*>(codes), dim);
+                break;
+            case VectorCodec::SQ4:
+                params = Math::QuantizeSQ4(dense_vec.data(), reinterpret_cast<uint8_t*>(codes), dim);
+                break;
+            case VectorCodec::Binary:
+                params = Math::QuantizeBinary(dense_vec.data(), reinterpret_cast<uint8_t*>(codes), dim);
+                break;
+            case VectorCodec::PQ:
+                pq->Encode(dense_vec.data(), reinterpret_cast<uint8_t*>(codes));
+                break;
         }
+        Math::WriteRecordHeader(dest, codec, dim, subspaces, params);
+        std::fill(codes + code_bytes, dest + result.record.size(), 0); // Padding
+    }
 
-        // B. Write Scale & Bias
-        float scale = (max_val - min_val) / 255.0f;
-        float bias = min_val;
+    size_t ProcessingUnit::CommitDocument(const AnalysisResult& result, size_t staged_bytes) {
+        if (m_config.codec == Math::VectorCodec::PQ && !m_pq) CollectTrainingSample(result);
 
-        // Handle flatline case (avoid div by zero)
-        if (std::abs(max_val - min_val) < 1e-6) {
-            scale = 1.0f; 
-        }
+        if (!result.has_record) return 0;
 
-        std::memcpy(dest, &scale, sizeof(float));
-        dest += sizeof(float);
+        void* base = Core::MemoryManager::instance().get_base_addr();
+        if (!base) return 0;
 
-        std::memcpy(dest, &bias, sizeof(float));
-        dest += sizeof(float);
+        // 1. Document frequencies
+        m_idf_manager.UpdateDocs(result.terms);
 
-        // C. Quantize Loop -> Direct Memory Write
-        int8_t* q_dest = reinterpret_cast<int8_t*>(dest);
-        
-        for (size_t i = 0; i < VECTOR_DIM; ++i) {
-            float v = (i < dense_vec.size()) ? dense_vec[i] : 0.0f;
-            
-            // Formula: (val - min) / (max - min) * 255 + (-128)
-            float norm = (v - min_val) / (max_val - min_val);
-            float scaled = norm * 255.0f;
-            int result = static_cast<int>(std::round(scaled)) - 128;
+        // 2. Stage in the Ghost Memory vector log, right after the records already staged.
+        // Nothing is visible until PublishRecords moves the head past it.
+        auto* header = reinterpret_cast<Core::MemoryHeader*>(base);
+        char* dest = static_cast<char*>(base) + header->head_offset + staged_bytes;
+        std::memcpy(dest, result.record.data(), result.record.size());
+        return result.record.size();
+    }
 
-            // Clamp
-            if (result < -128) result = -128;
-            if (result > 127) result = 127;
+    void ProcessingUnit::CollectTrainingSample(const AnalysisResult& result) {
+        // Training records are SQ8; decode them back to floats for k-means
+        if (result.has_record) {
+            Math::VectorRecordHeader header;
+            std::memcpy(&header, result.record.data(), sizeof(header));
+            const auto* codes = reinterpret_cast<const int8_t*>(result.record.data() + sizeof(header));
+            const Math::QuantParams params = header.params.quant;
+            for (size_t i = 0; i < header.dim; ++i) {
+                m_pq_samples.push_back((static_cast<float>(codes[i]) + 128.0f) * params.scale + params.bias);
+            }
+        }
+        if (++m_pq_training_docs == PQ_TRAIN_DOCS) TrainCodebook();
+    }
+
+    void ProcessingUnit::TrainCodebook() {
+        const size_t dim = m_config.vector_dim;
+        const size_t subspaces = m_config.pq_subspaces;
+        m_pq = std::make_unique<Math::ProductQuantizer>(dim, subspaces);
+        m_pq->Train(m_pq_samples.data(), m_pq_samples.size() / dim);
+        std::vector<float>().swap(m_pq_samples);
+
+        m_pq_ready.store(m_pq.get(), std::memory_order_release);
+
+        // Saved right away, through a temporary file and a rename, so the next run encodes
+        // with the same codebook instead of retraining on different documents
+        const PQCodebookHeader header{PQ_CODEBOOK_MAGIC, static_cast<uint32_t>(dim), static_cast<uint32_t>(subspaces), 0};
+        const auto codebook = m_pq->Codebook();
+        const std::string temporary = m_config.codebook_path + ".tmp";
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(codebook.data()), static_cast<std::streamsize>(codebook.size_bytes()));
+        out.close();
+        if (!out || std::rename(temporary.c_str(), m_config.codebook_path.c_str()) != 0) {
+            std::cerr << "WARN: cannot write PQ codebook '" << m_config.codebook_path << "'" << std::endl;
+            std::remove(temporary.c_str());
+        }
+    }
+
+    void ProcessingUnit::SaveVocabulary() {
+        // Nothing new since the file was mapped
+        if (m_saved_vocabulary && m_saved_vocabulary->size() == m_vocabulary.size() &&
+            m_saved_vocabulary->TotalDocs() == m_idf_manager.TotalDocs()) {
+            return;
+        }
+        std::vector<uint32_t> doc_freqs(m_idf_manager.DocFreqCount());
+        for (size_t id = 0; id < doc_freqs.size(); ++id) {
+            doc_freqs[id] = m_idf_manager.GetDocFreq(static_cast<TermID>(id));
+        }
+        MappedVocabulary::Write(m_config.vocab_path, m_vocabulary, doc_freqs, m_idf_manager.TotalDocs());
+    }
 
-            q_dest[i] = static_cast<int8_t>(result);
+    void ProcessingUnit::LoadCodebook() {
+        if (m_config.reset_db) return;
+        std::ifstream in(m_config.codebook_path, std::ios::binary);
+        if (!in) return;
+
+        // The file must hold exactly one codebook for this --dim / --pq-subspaces
+        PQCodebookHeader header{};
+        std::vector<float> codebook(m_config.vector_dim * Math::PQ_CENTROIDS);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        in.read(reinterpret_cast<char*>(codebook.data()), static_cast<std::streamsize>(codebook.size() * sizeof(float)));
+        const bool complete = in && in.peek() == std::ifstream::traits_type::eof();
+        if (!complete || header.magic != PQ_CODEBOOK_MAGIC || header.dim != m_config.vector_dim ||
+            header.subspaces != m_config.pq_subspaces) {
+            std::cerr << "WARN: PQ codebook '" << m_config.codebook_path
+                      << "' does not match --dim / --pq-subspaces, retraining" << std::endl;
+            return;
         }
+        m_pq = std::make_unique<Math::ProductQuantizer>(m_config.vector_dim, m_config.pq_subspaces, codebook);
+        m_pq_ready.store(m_pq.get(), std::memory_order_release);
+    }
 
-        // Advance destination pointer past the vector data (256 bytes)
-        // dest += VECTOR_DIM (Handled implicitly by q_dest indexing)
+    void ProcessingUnit::PublishRecords(size_t count, size_t bytes) {
+        void* base = Core::MemoryManager::instance().get_base_addr();
+        if (!base) return;
+        auto* header = reinterpret_cast<Core::MemoryHeader*>(base);
 
         // Update Header
-        // Commit the new offset
-        header->head_offset += entry_size;
-        
-        // Atomically increment the vector count so the UI sees it instantly
-        std::atomic_ref<uint64_t>(header->vector_count).fetch_add(1, std::memory_order_release);
+        // The commit thread is the only writer, so plain stores replace the per-document
+        // fetch_add; the release on vector_count publishes every record of the run.
+        std::atomic_ref<uint64_t>(header->head_offset).store(header->head_offset + bytes,
+                                                            std::memory_order_relaxed);
+        std::atomic_ref<uint64_t>(header->vector_count).store(header->vector_count + count,
+                                                             std::memory_order_release);
+
+        // Stay one window ahead of the append head so the next records land on warm pages
+        size_t window = header->head_offset / PREFETCH_WINDOW;
+        if (window != m_prefetch_window) {
+            m_prefetch_window = window;
+            Core::MemoryManager::instance().prefetch((window + 1) * PREFETCH_WINDOW, PREFETCH_WINDOW);
+        }
 
         // Debug Log
-        // std::cout << "[Engine] Stored Doc at offset " << current_offset << std::endl;
+        // std::cout << "[Engine] Published " << count << " docs, log head now " << header->head_offset << std::endl;
     }
 
 }
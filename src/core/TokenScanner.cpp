@@ -0,0 +1,281 @@
+#include "core/TokenScanner.hpp"
+#include "core/Unicode.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+#elif defined(__x86_64__)
+    #include <immintrin.h>
+#endif
+
+namespace Hyperion {
+
+    namespace {
+
+        // Bits [from, to) of a 64-bit mask (from < to <= 64)
+        inline uint64_t RangeMask(size_t from, size_t to) {
+            const uint64_t below_to = to >= 64 ? ~uint64_t{0} : (uint64_t{1} << to) - 1;
+            return below_to & ~((uint64_t{1} << from) - 1);
+        }
+
+        inline bool IsUpper(unsigned char c) { return static_cast<unsigned>(c - 'A') < 26u; }
+        inline bool IsAlnum(unsigned char c) {
+            return static_cast<unsigned>(c - '0') < 10u || static_cast<unsigned>((c | 0x20) - 'a') < 26u;
+        }
+
+        // One bit per byte of a block
+        struct BlockMasks {
+            uint64_t word;  // ASCII alphanumeric, or any byte >= 0x80 (part of a UTF-8 sequence)
+            uint64_t upper; // 'A'..'Z'
+            uint64_t high;  // >= 0x80
+        };
+
+        // Every classifier fills the masks and the block with 'A'..'Z' lowercased
+        [[maybe_unused]] void ClassifyScalar(const char* block, BlockMasks& masks, char* lowered) {
+            masks = BlockMasks{};
+            for (size_t i = 0; i < TokenScanner::BLOCK; ++i) {
+                const auto c = static_cast<unsigned char>(block[i]);
+                masks.word |= uint64_t{IsAlnum(c) || c >= 0x80} << i;
+                masks.upper |= uint64_t{IsUpper(c)} << i;
+                masks.high |= uint64_t{c >= 0x80} << i;
+                lowered[i] = static_cast<char>(IsUpper(c) ? c | 0x20 : c);
+            }
+        }
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+        // 16 byte-masks (0x00 / 0xFF) -> 16 bits: weight each lane by its bit, add per half
+        inline uint64_t MoveMask(uint8x16_t mask) {
+            static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+            const uint8x16_t bits = vandq_u8(mask, vld1q_u8(weights));
+            return vaddv_u8(vget_low_u8(bits)) | (static_cast<uint64_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+        }
+
+        void ClassifyBlock(const char* block, BlockMasks& masks, char* lowered) {
+            const uint8x16_t ten = vdupq_n_u8(10);
+            const uint8x16_t twenty_six = vdupq_n_u8(26);
+            masks = BlockMasks{};
+            for (size_t i = 0; i < TokenScanner::BLOCK; i += 16) {
+                const uint8x16_t c = vld1q_u8(reinterpret_cast<const uint8_t*>(block + i));
+                // Unsigned range checks: c - lo < len
+                const uint8x16_t digit = vcltq_u8(vsubq_u8(c, vdupq_n_u8('0')), ten);
+                const uint8x16_t letter = vcltq_u8(vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a')), twenty_six);
+                const uint8x16_t caps = vcltq_u8(vsubq_u8(c, vdupq_n_u8('A')), twenty_six);
+                const uint8x16_t high = vcgeq_u8(c, vdupq_n_u8(0x80));
+                masks.word |= MoveMask(vorrq_u8(vorrq_u8(digit, letter), high)) << i;
+                masks.upper |= MoveMask(caps) << i;
+                masks.high |= MoveMask(high) << i;
+                vst1q_u8(reinterpret_cast<uint8_t*>(lowered + i), vorrq_u8(c, vandq_u8(caps, vdupq_n_u8(0x20))));
+            }
+        }
+
+        const char* ClassifierName() { return "neon"; }
+
+#elif defined(__x86_64__)
+
+        // Signed compares only: shift [lo, hi] onto [-128, -128 + (hi - lo)], then one cmplt
+        inline __m128i InRange(__m128i c, char lo, char hi) {
+            const __m128i shifted = _mm_add_epi8(c, _mm_set1_epi8(static_cast<char>(0x80 - lo)));
+            return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + (hi - lo) + 1)));
+        }
+
+        void ClassifySSE2(const char* block, BlockMasks& masks, char* lowered) {
+            const __m128i case_bit = _mm_set1_epi8(0x20);
+            masks = BlockMasks{};
+            for (size_t i = 0; i < TokenScanner::BLOCK; i += 16) {
+                const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+                const __m128i letter = InRange(_mm_or_si128(c, case_bit), 'a', 'z');
+                const __m128i digit = InRange(c, '0', '9');
+                const __m128i caps = InRange(c, 'A', 'Z');
+                // movemask reads the sign bits, which are exactly the bytes >= 0x80
+                const auto high = static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(c)));
+                masks.word |= (static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_or_si128(letter, digit)))) | high) << i;
+                masks.upper |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(caps))) << i;
+                masks.high |= high << i;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lowered + i), _mm_or_si128(c, _mm_and_si128(caps, case_bit)));
+            }
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256i InRange256(__m256i c, char lo, char hi) {
+            const __m256i shifted = _mm256_add_epi8(c, _mm256_set1_epi8(static_cast<char>(0x80 - lo)));
+            return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + (hi - lo) + 1)), shifted);
+        }
+
+        // 32 bytes -> masks (in the low half) and lowercased bytes
+        __attribute__((target("avx2")))
+        inline BlockMasks Classify32(const char* bytes, char* lowered) {
+            const __m256i case_bit = _mm256_set1_epi8(0x20);
+            const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+            const __m256i letter = InRange256(_mm256_or_si256(c, case_bit), 'a', 'z');
+            const __m256i token = _mm256_or_si256(letter, InRange256(c, '0', '9'));
+            const __m256i caps = InRange256(c, 'A', 'Z');
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lowered), _mm256_or_si256(c, _mm256_and_si256(caps, case_bit)));
+            const uint64_t high = static_cast<uint32_t>(_mm256_movemask_epi8(c));
+            return BlockMasks{
+                static_cast<uint32_t>(_mm256_movemask_epi8(token)) | high,
+                static_cast<uint32_t>(_mm256_movemask_epi8(caps)),
+                high};
+        }
+
+        __attribute__((target("avx2")))
+        void ClassifyAVX2(const char* block, BlockMasks& masks, char* lowered) {
+            const BlockMasks lo = Classify32(block, lowered);
+            const BlockMasks hi = Classify32(block + 32, lowered + 32);
+            masks = BlockMasks{lo.word | (hi.word << 32), lo.upper | (hi.upper << 32), lo.high | (hi.high << 32)};
+        }
+
+        using ClassifyFn = void (*)(const char*, BlockMasks&, char*);
+
+        struct Classifier {
+            ClassifyFn fn;
+            const char* name;
+        };
+
+        const Classifier& ActiveClassifier() {
+            static const Classifier classifier = [] {
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx2")) return Classifier{ClassifyAVX2, "avx2"};
+                return Classifier{ClassifySSE2, "sse2"};
+            }();
+            return classifier;
+        }
+
+        void ClassifyBlock(const char* block, BlockMasks& masks, char* lowered) {
+            ActiveClassifier().fn(block, masks, lowered);
+        }
+
+        const char* ClassifierName() { return ActiveClassifier().name; }
+
+#else
+
+        void ClassifyBlock(const char* block, BlockMasks& masks, char* lowered) {
+            ClassifyScalar(block, masks, lowered);
+        }
+
+        const char* ClassifierName() { return "scalar"; }
+
+#endif
+
+    } // namespace
+
+    TokenScanner::TokenScanner(std::string_view text, std::pmr::memory_resource* scratch)
+        : m_text(text), m_lowered(scratch) {
+        LoadBlock(0);
+    }
+
+    const char* TokenScanner::KernelName() { return ClassifierName(); }
+
+    bool TokenScanner::LoadBlock(size_t offset) {
+        if (offset >= m_text.size()) return false;
+        m_block = offset;
+        m_bit = 0;
+
+        BlockMasks masks;
+        if (m_text.size() - offset >= BLOCK) {
+            ClassifyBlock(m_text.data() + offset, masks, m_lowered_block);
+        } else {
+            // Last partial block: zero padding is a separator, so tokens end at the text
+            alignas(64) char tail[BLOCK] = {};
+            std::memcpy(tail, m_text.data() + offset, m_text.size() - offset);
+            ClassifyBlock(tail, masks, m_lowered_block);
+        }
+        m_word = masks.word;
+        m_high = masks.high;
+        m_source = masks.upper != 0 ? m_lowered_block : m_text.data() + offset;
+        return true;
+    }
+
+    bool TokenScanner::Next(std::string_view& token) {
+        for (;;) {
+            // A run with non-ASCII bytes in progress: decode it code point by code point
+            if (m_run_pos < m_run_end && NextInRun(token)) return true;
+
+            // 1. Skip separators to the next run of word bytes
+            for (;;) {
+                if (m_bit >= BLOCK && !LoadBlock(m_block + BLOCK)) return false;
+                const uint64_t rest = m_word >> m_bit;
+                if (rest != 0) {
+                    m_bit += static_cast<size_t>(std::countr_zero(rest));
+                    break;
+                }
+                m_bit = BLOCK;
+            }
+            const size_t start = m_block + m_bit;
+
+            // 2. Run to the next separator byte, possibly across blocks, noting non-ASCII bytes
+            bool high = false;
+            for (;;) {
+                const uint64_t rest = ~m_word >> m_bit;
+                if (rest != 0) {
+                    const size_t end_bit = m_bit + static_cast<size_t>(std::countr_zero(rest));
+                    high |= (m_high & RangeMask(m_bit, end_bit)) != 0;
+                    m_bit = end_bit;
+                    break;
+                }
+                high |= (m_high >> m_bit) != 0;
+                if (!LoadBlock(m_block + BLOCK)) {
+                    m_bit = BLOCK; // Run goes to the end of the text
+                    break;
+                }
+            }
+            const size_t end = m_block + m_bit;
+
+            if (high) {
+                // Only runs that contain multibyte sequences leave the SIMD path
+                m_run_pos = start;
+                m_run_end = end;
+                continue;
+            }
+
+            if (start >= m_block) {
+                // Within one block: no per-token case test, the block already chose its source
+                token = std::string_view(m_source + (start - m_block), end - start);
+            } else {
+                m_lowered.assign(m_text.substr(start, end - start));
+                for (char& c : m_lowered) {
+                    if (IsUpper(static_cast<unsigned char>(c))) c = static_cast<char>(c | 0x20);
+                }
+                token = m_lowered;
+            }
+            return true;
+        }
+    }
+
+    bool TokenScanner::NextInRun(std::string_view& token) {
+        // Word bytes never include ASCII separators, and every byte of a multibyte
+        // sequence is >= 0x80, so a well-formed code point never straddles the run's end
+        m_lowered.clear();
+        while (m_run_pos < m_run_end) {
+            // ASCII inside a run is always alphanumeric
+            const auto byte = static_cast<unsigned char>(m_text[m_run_pos]);
+            if (byte < 0x80) {
+                m_lowered.push_back(static_cast<char>(IsUpper(byte) ? byte | 0x20 : byte));
+                ++m_run_pos;
+                continue;
+            }
+
+            size_t length;
+            const char32_t cp = Unicode::Decode(m_text.data() + m_run_pos, m_run_end - m_run_pos, length);
+            const Unicode::WordClass word_class = Unicode::Classify(cp);
+
+            if (word_class == Unicode::WordClass::Separator) {
+                m_run_pos += length;
+                if (!m_lowered.empty()) break;
+                continue;
+            }
+            // An ideograph is a token by itself: it ends the current token first
+            if (word_class == Unicode::WordClass::Ideograph && !m_lowered.empty()) break;
+
+            Unicode::Append(m_lowered, Unicode::Fold(cp));
+            m_run_pos += length;
+            if (word_class == Unicode::WordClass::Ideograph) break;
+        }
+        if (m_lowered.empty()) return false;
+        token = m_lowered;
+        return true;
+    }
+
+} // namespace Hyperion
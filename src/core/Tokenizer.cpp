@@ -1,78 +1,75 @@
 #include "../../include/core/Tokenizer.hpp"
-#include <cctype>
-#include <algorithm>
+#include "../../include/core/TokenScanner.hpp"
 
 namespace Hyperion {
 
     // --- Tokenizer Implementation ---
 
-    Tokenizer::Tokenizer() {
-        // Basic stopwords
-        std::vector<std::string> stops = {
-            "the", "of", "and", "a", "to", "in", "is", "you", "that", "it", 
-            "he", "was", "for", "on", "are", "as", "with", "his", "they", "i"
-        };
-        for (const auto& s : stops) m_stopwords.insert(s);
-    }
+    // Basic stopwords
+    static const std::vector<std::string_view> STOPWORDS = {
+        "the", "of", "and", "a", "to", "in", "is", "you", "that", "it",
+        "he", "was", "for", "on", "are", "as", "with", "his", "they", "i"
+    };
 
-    std::unordered_map<TermID, int> Tokenizer::Tokenize(std::string_view text) {
-        std::unordered_map<TermID, int> counts;
-        std::string current_token;
-        current_token.reserve(32);
+    Tokenizer::Tokenizer() : m_stopwords(STOPWORDS) {}
 
-        for (char c : text) {
-            if (std::isalnum(static_cast<unsigned char>(c))) {
-                current_token.push_back(std::tolower(static_cast<unsigned char>(c)));
-            } else if (!current_token.empty()) {
-                // Process token
-                if (!IsStopWord(current_token)) {
-                    counts[GetTermID(current_token)]++;
-                }
-                current_token.clear();
-            }
-        }
-        // Last token
-        if (!current_token.empty() && !IsStopWord(current_token)) {
-             counts[GetTermID(current_token)]++;
+    Tokenizer::Tokenizer(ConcurrentVocabulary& shared) : m_stopwords(STOPWORDS), m_shared(&shared) {}
+
+    TermCounts Tokenizer::Tokenize(std::string_view text, std::pmr::memory_resource* scratch, PhraseHashes* phrases) {
+        TermCounts counts(scratch);
+        if (phrases && HasPhraseFeatures()) {
+            TokenizePhrases(text, scratch, counts, *phrases);
+            return counts;
         }
+        TokenScanner scanner(text, scratch);
 
+        // One hash per token: the stopword test is a multiply and a compare, and known
+        // terms resolve with a single probe of the vocabulary, allocating nothing
+        std::string_view token;
+        while (scanner.Next(token)) {
+            if (IsStopWord(token)) continue;
+            counts[GetTermID(token)]++;
+        }
         return counts;
     }
 
-    TermID Tokenizer::GetTermID(std::string_view token) {
-        std::string s(token);
-        if (m_vocab.find(s) == m_vocab.end()) {
-            m_vocab[s] = m_next_term_id;
-            if (m_inverse_vocab.size() <= m_next_term_id) {
-                m_inverse_vocab.resize(m_next_term_id + 100);
+    void Tokenizer::SetPhraseFeatures(size_t ngrams, size_t shingle, uint64_t seed) {
+        m_ngrams.Configure(ngrams, seed);
+        m_shingles.Configure(shingle, seed);
+        m_phrase_seed = seed;
+    }
+
+    // Same token stream as the plain loop, with both rolling generators riding along.
+    // Features go straight into 'phrases' as hashes: no n-gram or shingle text is built.
+    void Tokenizer::TokenizePhrases(std::string_view text, std::pmr::memory_resource* scratch,
+                                    TermCounts& counts, PhraseHashes& phrases) {
+        TokenScanner scanner(text, scratch);
+        m_ngrams.Reset();
+        m_shingles.Reset();
+        auto emit = [&phrases](uint64_t hash) { phrases.push_back(hash); };
+
+        bool first = true;
+        std::string_view token;
+        while (scanner.Next(token)) {
+            if (m_shingles.Enabled()) {
+                if (!first) m_shingles.Push(' ', emit);
+                for (char c : token) m_shingles.Push(static_cast<unsigned char>(c), emit);
+                first = false;
+            }
+            if (IsStopWord(token)) continue;
+            const TermID id = GetTermID(token);
+            counts[id]++;
+            if (m_ngrams.Enabled()) {
+                m_ngrams.Push(m_shared ? m_shared->Hash(id) : HashTerm(token, m_phrase_seed), emit);
             }
-            m_inverse_vocab[m_next_term_id] = s;
-            m_next_term_id++;
         }
-        return m_vocab[s];
     }
 
     std::string Tokenizer::GetTermString(TermID id) const {
-        if (id < m_inverse_vocab.size()) {
-            return m_inverse_vocab[id];
+        if (id != 0 && id <= (m_shared ? m_shared->size() : m_vocab.NextID() - size_t{1})) {
+            return std::string(GetTerm(id));
         }
         return "UNKNOWN";
     }
 
-    bool Tokenizer::IsStopWord(std::string_view token) const {
-        return m_stopwords.contains(std::string(token));
-    }
-
-    void Tokenizer::SetVocab(const std::vector<std::string>& inverse_vocab) {
-        m_inverse_vocab = inverse_vocab;
-        m_vocab.clear();
-        m_next_term_id = 1;
-        for (size_t i = 1; i < inverse_vocab.size(); ++i) {
-            if (!inverse_vocab[i].empty()) {
-                m_vocab[inverse_vocab[i]] = i;
-                if (i >= m_next_term_id) m_next_term_id = i + 1;
-            }
-        }
-    }
-
 } // namespace Hyperion
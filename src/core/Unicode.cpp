@@ -0,0 +1,199 @@
+#include "core/Unicode.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Hyperion::Unicode {
+
+    namespace {
+
+        struct Range {
+            char32_t first;
+            char32_t last;
+        };
+
+        // Non-ASCII code points that separate words. Sorted, non-overlapping. Anything
+        // not listed (and not an ideograph) is treated as part of a word: letters, digits
+        // and combining marks of every script fall through to Word without a table.
+        constexpr Range SEPARATORS[] = {
+            {0x0080, 0x00A9}, {0x00AB, 0x00B4}, {0x00B6, 0x00B9}, {0x00BB, 0x00BF}, // C1 controls, NBSP, Latin-1 punctuation
+            {0x00D7, 0x00D7}, {0x00F7, 0x00F7},                                     // × ÷
+            {0x02C2, 0x02C5}, {0x02D2, 0x02DF},                                     // Modifier symbols
+            {0x037E, 0x037E}, {0x0387, 0x0387},                                     // Greek question mark, ano teleia
+            {0x055A, 0x055F}, {0x0589, 0x058A},                                     // Armenian punctuation
+            {0x05BE, 0x05BE}, {0x05C0, 0x05C0}, {0x05C3, 0x05C3}, {0x05C6, 0x05C6}, {0x05F3, 0x05F4}, // Hebrew
+            {0x0600, 0x060F}, {0x061B, 0x061F}, {0x066A, 0x066D}, {0x06D4, 0x06D4}, // Arabic
+            {0x0964, 0x0965}, {0x0970, 0x0970},                                     // Devanagari danda
+            {0x0E3F, 0x0E3F}, {0x0E4F, 0x0E4F}, {0x0E5A, 0x0E5B},                   // Thai
+            {0x10FB, 0x10FB}, {0x1360, 0x1368},                                     // Georgian, Ethiopic
+            {0x166D, 0x166E}, {0x1680, 0x1680}, {0x169B, 0x169C},                   // Canadian syllabics, Ogham
+            {0x16EB, 0x16ED}, {0x1735, 0x1736}, {0x17D4, 0x17DB},                   // Runic, Philippine, Khmer
+            {0x1800, 0x180A},                                                       // Mongolian
+            {0x2000, 0x206F},                                                       // General punctuation, spaces
+            {0x20A0, 0x20CF},                                                       // Currency
+            {0x2100, 0x2101}, {0x2103, 0x2106}, {0x2108, 0x2109}, {0x2114, 0x2114}, // Letterlike symbols
+            {0x2116, 0x2118}, {0x211E, 0x2123}, {0x2125, 0x2125}, {0x2127, 0x2127},
+            {0x2129, 0x2129}, {0x212E, 0x212E}, {0x213A, 0x213B}, {0x2140, 0x2144},
+            {0x214A, 0x214D}, {0x214F, 0x214F},
+            {0x2190, 0x2BFF},                                                       // Arrows, math, technical, box drawing, shapes, dingbats
+            {0x2CF9, 0x2CFC}, {0x2CFE, 0x2CFF},                                     // Coptic punctuation
+            {0x2E00, 0x2E7F},                                                       // Supplemental punctuation
+            {0x2E80, 0x2FFF},                                                       // CJK radicals, ideographic description
+            {0x3000, 0x3004}, {0x3008, 0x3020}, {0x3030, 0x3030}, {0x303D, 0x303F}, // CJK symbols and punctuation
+            {0x30A0, 0x30A0}, {0x30FB, 0x30FB},                                     // Katakana double hyphen, middle dot
+            {0x3200, 0x33FF},                                                       // Enclosed CJK, compatibility
+            {0x4DC0, 0x4DFF},                                                       // Yijing hexagrams
+            {0xA4FE, 0xA4FF}, {0xA60D, 0xA60F}, {0xA673, 0xA673}, {0xA67E, 0xA67E},
+            {0xD800, 0xF8FF},                                                       // Surrogates, private use
+            {0xFD3E, 0xFD3F},                                                       // Ornate parentheses
+            {0xFE10, 0xFE1F}, {0xFE30, 0xFE6F},                                     // Vertical, compatibility, small forms
+            {0xFEFF, 0xFEFF},                                                       // Byte order mark
+            {0xFF00, 0xFF0F}, {0xFF1A, 0xFF20}, {0xFF3B, 0xFF40}, {0xFF5B, 0xFF65}, // Fullwidth punctuation
+            {0xFFE0, 0xFFFF},                                                       // Fullwidth signs, specials, U+FFFD
+            {0x10100, 0x1013F},                                                     // Aegean numbers
+            {0x1D000, 0x1D24F},                                                     // Musical symbols
+            {0x1F000, 0x1FAFF},                                                     // Tiles, cards, emoji, pictographs
+            {0xE0000, 0xE007F},                                                     // Tags
+            {0xF0000, 0x10FFFF},                                                    // Supplementary private use
+        };
+
+        constexpr Range IDEOGRAPHS[] = {
+            {0x3005, 0x3007},   // 々 〆 〇
+            {0x3021, 0x3029},   // Hangzhou numerals
+            {0x3038, 0x303C},
+            {0x3040, 0x309F},   // Hiragana
+            {0x3400, 0x4DBF},   // CJK Extension A
+            {0x4E00, 0x9FFF},   // CJK Unified Ideographs
+            {0xF900, 0xFAFF},   // CJK Compatibility Ideographs
+            {0x20000, 0x3FFFF}, // Planes 2-3: CJK Extensions B and later
+        };
+
+        constexpr bool InRanges(const Range* begin, const Range* end, char32_t cp) {
+            const Range* it = std::upper_bound(begin, end, cp, [](char32_t value, const Range& r) { return value < r.first; });
+            return it != begin && cp <= (it - 1)->last;
+        }
+
+        constexpr bool Sorted(const Range* begin, const Range* end) {
+            for (const Range* r = begin; r != end; ++r) {
+                if (r->first > r->last || (r + 1 != end && r->last >= (r + 1)->first)) return false;
+            }
+            return true;
+        }
+        static_assert(Sorted(std::begin(SEPARATORS), std::end(SEPARATORS)), "SEPARATORS must be sorted and disjoint");
+        static_assert(Sorted(std::begin(IDEOGRAPHS), std::end(IDEOGRAPHS)), "IDEOGRAPHS must be sorted and disjoint");
+
+        // Upper/lower pairs at consecutive code points (even -> odd, or odd -> even)
+        constexpr char32_t FoldPair(char32_t cp, bool upper_even) {
+            return ((cp & 1) == 0) == upper_even ? cp + 1 : cp;
+        }
+
+    } // namespace
+
+    char32_t Decode(const char* p, size_t size, size_t& length) {
+        const auto b0 = static_cast<unsigned char>(p[0]);
+        length = 1;
+        if (b0 < 0x80) return b0;
+
+        size_t need;
+        char32_t cp;
+        char32_t min;
+        if (b0 >= 0xC2 && b0 <= 0xDF) { need = 1; cp = b0 & 0x1F; min = 0x80; }
+        else if (b0 >= 0xE0 && b0 <= 0xEF) { need = 2; cp = b0 & 0x0F; min = 0x800; }
+        else if (b0 >= 0xF0 && b0 <= 0xF4) { need = 3; cp = b0 & 0x07; min = 0x10000; }
+        else return REPLACEMENT; // Continuation byte, C0/C1 overlong lead, or past U+10FFFF
+
+        if (size <= need) return REPLACEMENT;
+        for (size_t i = 1; i <= need; ++i) {
+            const auto b = static_cast<unsigned char>(p[i]);
+            if ((b & 0xC0) != 0x80) return REPLACEMENT;
+            cp = (cp << 6) | (b & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return REPLACEMENT;
+        length = need + 1;
+        return cp;
+    }
+
+    void Append(std::pmr::string& out, char32_t cp) {
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    WordClass Classify(char32_t cp) {
+        if (cp < 0x80) {
+            const bool alnum = (cp - U'0' < 10u) || ((cp | 0x20) - U'a' < 26u);
+            return alnum ? WordClass::Word : WordClass::Separator;
+        }
+        // Hot blocks first, so common scripts skip the range searches
+        if (cp >= 0xC0 && cp < 0x2C2) return cp == 0xD7 || cp == 0xF7 ? WordClass::Separator : WordClass::Word; // Latin
+        if (cp >= 0x400 && cp < 0x55A) return WordClass::Word;        // Cyrillic, Armenian letters
+        if (cp >= 0x4E00 && cp <= 0x9FFF) return WordClass::Ideograph; // CJK Unified Ideographs
+        if (cp >= 0xAC00 && cp <= 0xD7A3) return WordClass::Word;      // Hangul syllables
+
+        if (InRanges(std::begin(SEPARATORS), std::end(SEPARATORS), cp)) return WordClass::Separator;
+        if (InRanges(std::begin(IDEOGRAPHS), std::end(IDEOGRAPHS), cp)) return WordClass::Ideograph;
+        return WordClass::Word;
+    }
+
+    char32_t Fold(char32_t cp) {
+        if (cp < 0x80) return cp - U'A' < 26u ? cp + 0x20 : cp;
+        if (cp < 0x100) {
+            if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 0x20; // À..Þ
+            if (cp == 0xB5) return 0x3BC;                                  // Micro sign -> μ
+            return cp;
+        }
+        if (cp < 0x180) {                                                  // Latin Extended-A
+            if (cp == 0x130) return 0x69;                                  // İ -> i (no simple fold; matches 'istanbul')
+            if (cp == 0x178) return 0xFF;                                  // Ÿ -> ÿ
+            if (cp == 0x17F) return 0x73;                                  // ſ -> s
+            if (cp == 0x131 || cp == 0x138 || cp == 0x149) return cp;      // ı, ĸ, ŉ have no simple fold
+            if ((cp >= 0x139 && cp <= 0x148) || (cp >= 0x179 && cp <= 0x17E)) return FoldPair(cp, false);
+            return FoldPair(cp, true);
+        }
+        if (cp >= 0x1CD && cp <= 0x1DC) return FoldPair(cp, false);       // Latin Extended-B pinyin vowels
+        if ((cp >= 0x1DE && cp <= 0x1EF) || (cp >= 0x1F8 && cp <= 0x21F) || (cp >= 0x222 && cp <= 0x233)) {
+            return FoldPair(cp, true);
+        }
+        if (cp >= 0x370 && cp < 0x400) {                                   // Greek
+            if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) return cp + 0x20;
+            if (cp == 0x386) return 0x3AC;
+            if (cp >= 0x388 && cp <= 0x38A) return cp + 0x25;
+            if (cp == 0x38C) return 0x3CC;
+            if (cp == 0x38E || cp == 0x38F) return cp + 0x3F;
+            if (cp == 0x3C2) return 0x3C3;                                 // Final sigma folds to σ
+            if (cp >= 0x3D8 && cp <= 0x3EF) return FoldPair(cp, true);
+            return cp;
+        }
+        if (cp >= 0x400 && cp < 0x530) {                                   // Cyrillic
+            if (cp <= 0x40F) return cp + 0x50;
+            if (cp <= 0x42F) return cp + 0x20;
+            if ((cp >= 0x460 && cp <= 0x481) || (cp >= 0x48A && cp <= 0x4BF) || cp >= 0x4D0) return FoldPair(cp, true);
+            if (cp == 0x4C0) return 0x4CF;
+            if (cp >= 0x4C1 && cp <= 0x4CE) return FoldPair(cp, false);
+            return cp;
+        }
+        if (cp >= 0x531 && cp <= 0x556) return cp + 0x30;                 // Armenian
+        if (cp >= 0x1E00 && cp <= 0x1EFF) {                               // Latin Extended Additional
+            if (cp == 0x1E9E) return 0xDF;                                 // ẞ -> ß
+            if (cp <= 0x1E95 || cp >= 0x1EA0) return FoldPair(cp, true);
+            return cp;
+        }
+        if (cp >= 0xFF10 && cp <= 0xFF19) return cp - 0xFF10 + U'0';       // Fullwidth digits
+        if (cp >= 0xFF21 && cp <= 0xFF3A) return cp - 0xFF21 + U'a';       // Fullwidth capitals
+        if (cp >= 0xFF41 && cp <= 0xFF5A) return cp - 0xFF41 + U'a';       // Fullwidth small letters
+        return cp;
+    }
+
+} // namespace Hyperion::Unicode
@@ -0,0 +1,289 @@
+#include "core/Vocabulary.hpp"
+#include "core/FeatureHash.hpp"
+#include "core/VocabularyFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace Hyperion {
+
+    // --- Vocabulary ---
+
+    // Vocabulary hashing is internal, so it has its own fixed seed (not --hash-seed)
+    static constexpr uint64_t VOCAB_SEED = 0x7E63'AB0C'4D1F'92E5ULL;
+    static constexpr size_t INITIAL_SLOTS = 1024;
+
+    Vocabulary::Vocabulary() {
+        clear();
+    }
+
+    void Vocabulary::clear() {
+        m_chars.clear();
+        m_offsets.assign(2, 0); // Id 0 is the empty "unknown" term
+        m_slots.assign(INITIAL_SLOTS, Slot{0, 0});
+        m_count = 0;
+    }
+
+    uint32_t Vocabulary::Tag(std::string_view term) {
+        return static_cast<uint32_t>(HashTerm(term, VOCAB_SEED) >> 32);
+    }
+
+    size_t Vocabulary::Probe(std::string_view term, uint32_t tag) const {
+        const size_t mask = m_slots.size() - 1;
+        for (size_t index = tag & mask;; index = (index + 1) & mask) {
+            const Slot& slot = m_slots[index];
+            if (slot.id == 0) return index;
+            if (slot.tag == tag && Term(slot.id) == term) return index;
+        }
+    }
+
+    TermID Vocabulary::Find(std::string_view term) const {
+        return m_slots[Probe(term, Tag(term))].id;
+    }
+
+    TermID Vocabulary::Intern(std::string_view term) {
+        const uint32_t tag = Tag(term);
+        size_t index = Probe(term, tag);
+        if (m_slots[index].id != 0) return m_slots[index].id;
+
+        const TermID id = NextID();
+        m_chars.insert(m_chars.end(), term.begin(), term.end());
+        m_offsets.push_back(static_cast<uint32_t>(m_chars.size()));
+        m_slots[index] = Slot{tag, id};
+
+        // Keep the load factor at or below 1/2 so probe runs stay short
+        if (++m_count * 2 > m_slots.size()) Grow();
+        return id;
+    }
+
+    bool Vocabulary::InternAs(std::string_view term, TermID id) {
+        if (id == 0 || term.empty() || id < NextID()) return false;
+        const uint32_t tag = Tag(term);
+        const size_t index = Probe(term, tag);
+        if (m_slots[index].id != 0) return false;
+
+        // Ids skipped over become empty terms, which are never indexed
+        while (NextID() < id) m_offsets.push_back(static_cast<uint32_t>(m_chars.size()));
+        m_chars.insert(m_chars.end(), term.begin(), term.end());
+        m_offsets.push_back(static_cast<uint32_t>(m_chars.size()));
+        m_slots[index] = Slot{tag, id};
+
+        if (++m_count * 2 > m_slots.size()) Grow();
+        return true;
+    }
+
+    void Vocabulary::Insert(uint32_t tag, TermID id) {
+        // Rehash only: ids are unique, so there is nothing to compare
+        const size_t mask = m_slots.size() - 1;
+        size_t index = tag & mask;
+        while (m_slots[index].id != 0) index = (index + 1) & mask;
+        m_slots[index] = Slot{tag, id};
+    }
+
+    void Vocabulary::Grow() {
+        // Tags are kept in the slots, so rehashing never touches the strings
+        std::vector<Slot> old(m_slots.size() * 2, Slot{0, 0});
+        old.swap(m_slots);
+        for (const Slot& slot : old) {
+            if (slot.id != 0) Insert(slot.tag, slot.id);
+        }
+    }
+
+    // --- StopwordSet ---
+
+    StopwordSet::StopwordSet(const std::vector<std::string_view>& words) {
+        for (std::string_view word : words) {
+            if (word.empty() || word.size() > MAX_LENGTH) throw std::invalid_argument("StopwordSet: word must be 1-8 bytes");
+        }
+
+        // Deterministic candidate multipliers (splitmix64 sequence, forced odd)
+        uint64_t state = 0;
+        for (int attempt = 0; attempt < (1 << 16); ++attempt) {
+            state += 0x9E3779B97F4A7C15ULL;
+            m_multiplier = MixHash(state) | 1;
+
+            std::fill(std::begin(m_bits), std::end(m_bits), 0);
+            bool collision = false;
+            for (std::string_view word : words) {
+                const uint64_t key = Pack(word);
+                const size_t index = Index(key);
+                const uint64_t bit = uint64_t{1} << (index & 63);
+                if (m_bits[index >> 6] & bit) {
+                    collision = m_keys[index] != key; // A repeated word is not a collision
+                    if (collision) break;
+                }
+                m_bits[index >> 6] |= bit;
+                m_keys[index] = key;
+            }
+            if (!collision) return;
+        }
+        throw std::invalid_argument("StopwordSet: no collision-free multiplier for this word set");
+    }
+
+    // --- ConcurrentVocabulary ---
+
+    static constexpr size_t INITIAL_SHARD_SLOTS = 256;
+
+    ConcurrentVocabulary::Table::Table(size_t capacity)
+        : mask(capacity - 1), slots(new std::atomic<uint64_t>[capacity]) {
+        for (size_t i = 0; i < capacity; ++i) slots[i].store(0, std::memory_order_relaxed);
+    }
+
+    ConcurrentVocabulary::ConcurrentVocabulary(uint64_t seed, const MappedVocabulary* base)
+        : m_seed(seed), m_base(base), m_base_size(base ? base->size() : 0),
+          m_shards(new Shard[SHARDS]), m_segments(new std::atomic<Entry*>[MAX_SEGMENTS]) {
+        if (base && base->Seed() != seed) {
+            throw std::invalid_argument("ConcurrentVocabulary: base vocabulary was saved with another seed");
+        }
+        for (size_t i = 0; i < MAX_SEGMENTS; ++i) m_segments[i].store(nullptr, std::memory_order_relaxed);
+        for (size_t i = 0; i < SHARDS; ++i) {
+            Shard& shard = m_shards[i];
+            shard.tables.push_back(std::make_unique<Table>(INITIAL_SHARD_SLOTS));
+            shard.table.store(shard.tables.back().get(), std::memory_order_release);
+        }
+        // Id 0 is the empty "unknown" term
+        Entry& unknown = EntryFor(0);
+        unknown.data = "";
+        unknown.hash = 0;
+
+        m_next_id.store(static_cast<TermID>(m_base_size + 1), std::memory_order_relaxed);
+        m_size.store(m_base_size, std::memory_order_relaxed);
+    }
+
+    ConcurrentVocabulary::~ConcurrentVocabulary() {
+        for (size_t i = 0; i < MAX_SEGMENTS; ++i) delete[] m_segments[i].load(std::memory_order_relaxed);
+    }
+
+    TermID ConcurrentVocabulary::Probe(const Table& table, std::string_view term, uint64_t hash) const {
+        const uint64_t tag = hash >> 32;
+        for (size_t index = hash & table.mask;; index = (index + 1) & table.mask) {
+            // Acquire: the entry behind an id is written before the id is published
+            const uint64_t slot = table.slots[index].load(std::memory_order_acquire);
+            if (slot == 0) return 0;
+            if ((slot >> 32) == tag) {
+                const auto id = static_cast<TermID>(slot);
+                if (Term(id) == term) return id;
+            }
+        }
+    }
+
+    std::string_view ConcurrentVocabulary::BaseTerm(TermID id) const { return m_base->Term(id); }
+    uint64_t ConcurrentVocabulary::BaseHash(TermID id) const { return m_base->Hash(id); }
+
+    TermID ConcurrentVocabulary::Find(std::string_view term) const {
+        const uint64_t hash = HashTerm(term, m_seed);
+        if (m_base) {
+            if (TermID id = m_base->Find(term, hash)) return id;
+        }
+        const Shard& shard = ShardOf(m_shards.get(), hash);
+        return Probe(*shard.table.load(std::memory_order_acquire), term, hash);
+    }
+
+    TermID ConcurrentVocabulary::Intern(std::string_view term) {
+        const uint64_t hash = HashTerm(term, m_seed);
+        if (m_base) {
+            if (TermID id = m_base->Find(term, hash)) return id;
+        }
+        Shard& shard = ShardOf(m_shards.get(), hash);
+        if (TermID id = Probe(*shard.table.load(std::memory_order_acquire), term, hash)) return id;
+
+        TermID id;
+        {
+            std::lock_guard guard(shard.lock);
+            // Under the lock the table is current: a racing insert of the same term is visible
+            Table& table = *shard.table.load(std::memory_order_relaxed);
+            if (TermID existing = Probe(table, term, hash)) return existing;
+
+            id = m_next_id.fetch_add(1, std::memory_order_relaxed);
+            if (id > MAX_TERMS) {
+                m_next_id.store(static_cast<TermID>(MAX_TERMS + 1), std::memory_order_relaxed);
+                return 0;
+            }
+
+            Entry& entry = EntryFor(id);
+            entry.data = Store(shard, term);
+            entry.length = static_cast<uint32_t>(term.size());
+            entry.hash = hash;
+
+            size_t index = hash & table.mask;
+            while (table.slots[index].load(std::memory_order_relaxed) != 0) index = (index + 1) & table.mask;
+            table.slots[index].store(Pack(hash, id), std::memory_order_release);
+
+            // Keep the load factor at or below 1/2 so probe runs stay short
+            if (++shard.count * 2 > table.mask + 1) Grow(shard);
+
+            entry.ready.store(true, std::memory_order_seq_cst);
+        }
+        AdvanceSize();
+        return id;
+    }
+
+    ConcurrentVocabulary::Entry& ConcurrentVocabulary::EntryFor(TermID id) {
+        std::atomic<Entry*>& segment = m_segments[id >> SEGMENT_BITS];
+        Entry* entries = segment.load(std::memory_order_acquire);
+        if (!entries) {
+            // Shards allocate concurrently: the first CAS wins, losers free their copy
+            auto* fresh = new Entry[SEGMENT_SIZE]();
+            if (segment.compare_exchange_strong(entries, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                entries = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        return entries[id & (SEGMENT_SIZE - 1)];
+    }
+
+    const char* ConcurrentVocabulary::Store(Shard& shard, std::string_view term) {
+        if (term.size() > shard.left) {
+            // Oversized terms get a chunk of their own; the current chunk keeps its space
+            if (term.size() > ARENA_CHUNK / 4) {
+                shard.chunks.push_back(std::make_unique<char[]>(term.size()));
+                std::memcpy(shard.chunks.back().get(), term.data(), term.size());
+                return shard.chunks.back().get();
+            }
+            shard.chunks.push_back(std::make_unique<char[]>(ARENA_CHUNK));
+            shard.cursor = shard.chunks.back().get();
+            shard.left = ARENA_CHUNK;
+        }
+        char* dest = shard.cursor;
+        std::memcpy(dest, term.data(), term.size());
+        shard.cursor += term.size();
+        shard.left -= term.size();
+        return dest;
+    }
+
+    void ConcurrentVocabulary::Grow(Shard& shard) {
+        const Table& old = *shard.table.load(std::memory_order_relaxed);
+        auto grown = std::make_unique<Table>((old.mask + 1) * 2);
+        for (size_t i = 0; i <= old.mask; ++i) {
+            const uint64_t slot = old.slots[i].load(std::memory_order_relaxed);
+            if (slot == 0) continue;
+            // The index needs the low hash bits, which the slot's tag does not keep
+            size_t index = GetEntry(static_cast<TermID>(slot)).hash & grown->mask;
+            while (grown->slots[index].load(std::memory_order_relaxed) != 0) index = (index + 1) & grown->mask;
+            grown->slots[index].store(slot, std::memory_order_relaxed);
+        }
+        // Release: readers that load the new table see every slot copied into it
+        shard.table.store(grown.get(), std::memory_order_release);
+        shard.tables.push_back(std::move(grown));
+    }
+
+    void ConcurrentVocabulary::AdvanceSize() {
+        // Every inserter helps: move the published prefix over each consecutive ready entry.
+        // Ready flags and these loads are seq_cst, so of two inserters finishing neighbouring
+        // ids out of order at least one sees the other's flag and nothing is left behind.
+        size_t published = m_size.load(std::memory_order_seq_cst);
+        for (;;) {
+            const size_t next = published + 1;
+            if (next >= m_next_id.load(std::memory_order_seq_cst) || next > MAX_TERMS) return;
+            // The id may be handed out before its inserter has even allocated its segment
+            const Entry* segment = m_segments[next >> SEGMENT_BITS].load(std::memory_order_acquire);
+            if (!segment || !segment[next & (SEGMENT_SIZE - 1)].ready.load(std::memory_order_seq_cst)) return;
+            // On failure 'published' is reloaded and the walk resumes from there
+            if (m_size.compare_exchange_weak(published, next, std::memory_order_seq_cst)) published = next;
+        }
+    }
+
+} // namespace Hyperion
@@ -0,0 +1,213 @@
+#include "core/VocabularyFile.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Hyperion {
+
+    // "HYPVOCAB" read as a native word: a file from a machine of the other byte order fails it
+    static constexpr uint64_t VOCAB_FILE_MAGIC = 0x4241'434F'5650'5948ULL;
+    static constexpr uint32_t VOCAB_FILE_VERSION = 1;
+
+    struct VocabFileHeader {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t seed;
+        uint64_t terms;
+        uint64_t total_docs;
+        uint64_t index_slots;
+        uint64_t blob_offset;
+        uint64_t blob_bytes;
+        uint64_t offsets_offset;
+        uint64_t ranks_offset;
+        uint64_t hashes_offset;
+        uint64_t doc_freqs_offset;
+        uint64_t index_offset;
+        uint64_t file_bytes;
+    };
+
+    static constexpr uint64_t Align8(uint64_t value) { return (value + 7) & ~uint64_t{7}; }
+
+    // Section offsets for 'terms' terms whose bytes add up to 'blob_bytes'
+    static VocabFileHeader Layout(uint64_t terms, uint64_t blob_bytes) {
+        VocabFileHeader header{};
+        header.magic = VOCAB_FILE_MAGIC;
+        header.version = VOCAB_FILE_VERSION;
+        header.terms = terms;
+        // Load factor at most 1/2, as in the live vocabulary
+        header.index_slots = std::bit_ceil(std::max<uint64_t>(terms * 2, 16));
+        header.blob_offset = Align8(sizeof(VocabFileHeader));
+        header.blob_bytes = blob_bytes;
+        header.offsets_offset = Align8(header.blob_offset + blob_bytes);
+        header.ranks_offset = header.offsets_offset + (terms + 1) * sizeof(uint64_t);
+        header.hashes_offset = Align8(header.ranks_offset + (terms + 1) * sizeof(uint32_t));
+        header.doc_freqs_offset = header.hashes_offset + (terms + 1) * sizeof(uint64_t);
+        header.index_offset = Align8(header.doc_freqs_offset + (terms + 1) * sizeof(uint32_t));
+        header.file_bytes = header.index_offset + header.index_slots * sizeof(uint64_t);
+        return header;
+    }
+
+    MappedVocabulary::~MappedVocabulary() {
+        if (m_map) munmap(m_map, m_map_bytes);
+    }
+
+    std::unique_ptr<MappedVocabulary> MappedVocabulary::Open(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (errno != ENOENT) std::cerr << "WARN: cannot open vocabulary '" << path << "': " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(VocabFileHeader)) {
+            std::cerr << "WARN: vocabulary '" << path << "' is truncated, ignoring it" << std::endl;
+            close(fd);
+            return nullptr;
+        }
+        const size_t bytes = static_cast<size_t>(info.st_size);
+        void* map = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            std::cerr << "WARN: cannot map vocabulary '" << path << "': " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+
+        std::unique_ptr<MappedVocabulary> vocabulary(new MappedVocabulary());
+        vocabulary->m_map = map;
+        vocabulary->m_map_bytes = bytes;
+
+        // The header must describe exactly the layout Write produces for its counts; that
+        // bounds every section without touching the (possibly huge) arrays themselves
+        VocabFileHeader header;
+        std::memcpy(&header, map, sizeof(header));
+        const bool valid = header.magic == VOCAB_FILE_MAGIC && header.version == VOCAB_FILE_VERSION &&
+                           header.terms <= ConcurrentVocabulary::MAX_TERMS &&
+                           header.blob_bytes <= bytes && header.file_bytes == bytes;
+        VocabFileHeader expected = Layout(valid ? header.terms : 0, valid ? header.blob_bytes : 0);
+        expected.seed = header.seed;
+        expected.total_docs = header.total_docs;
+        expected.reserved = header.reserved;
+        if (!valid || std::memcmp(&header, &expected, sizeof(header)) != 0) {
+            std::cerr << "WARN: '" << path << "' is not a vocabulary file of this version, ignoring it" << std::endl;
+            return nullptr;
+        }
+
+        const char* base = static_cast<const char*>(map);
+        vocabulary->m_size = header.terms;
+        vocabulary->m_seed = header.seed;
+        vocabulary->m_total_docs = header.total_docs;
+        vocabulary->m_index_mask = header.index_slots - 1;
+        vocabulary->m_blob = base + header.blob_offset;
+        vocabulary->m_blob_bytes = header.blob_bytes;
+        vocabulary->m_offsets = reinterpret_cast<const uint64_t*>(base + header.offsets_offset);
+        vocabulary->m_ranks = reinterpret_cast<const uint32_t*>(base + header.ranks_offset);
+        vocabulary->m_hashes = reinterpret_cast<const uint64_t*>(base + header.hashes_offset);
+        vocabulary->m_doc_freqs = reinterpret_cast<const uint32_t*>(base + header.doc_freqs_offset);
+        vocabulary->m_index = reinterpret_cast<const uint64_t*>(base + header.index_offset);
+
+        if (vocabulary->m_offsets[0] != 0 || vocabulary->m_offsets[header.terms] != header.blob_bytes) {
+            std::cerr << "WARN: vocabulary '" << path << "' is damaged, ignoring it" << std::endl;
+            return nullptr;
+        }
+        // Lookups land anywhere in the index and the blob
+        madvise(map, bytes, MADV_RANDOM);
+        return vocabulary;
+    }
+
+    bool MappedVocabulary::Write(const std::string& path, const ConcurrentVocabulary& vocabulary,
+                                 std::span<const uint32_t> doc_freqs, uint64_t total_docs) {
+        const size_t terms = vocabulary.size();
+        std::vector<TermID> order(terms);
+        std::iota(order.begin(), order.end(), TermID{1});
+        std::sort(order.begin(), order.end(),
+                  [&](TermID a, TermID b) { return vocabulary.Term(a) < vocabulary.Term(b); });
+
+        uint64_t blob_bytes = 0;
+        for (TermID id : order) blob_bytes += vocabulary.Term(id).size();
+
+        VocabFileHeader header = Layout(terms, blob_bytes);
+        header.seed = vocabulary.Seed();
+        header.total_docs = total_docs;
+
+        const std::string temporary = path + ".tmp";
+        int fd = open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "WARN: cannot write vocabulary '" << temporary << "': " << strerror(errno) << std::endl;
+            return false;
+        }
+        void* map = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(header.file_bytes)) == 0) {
+            map = mmap(nullptr, header.file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (map == MAP_FAILED) {
+            std::cerr << "WARN: cannot write vocabulary '" << temporary << "': " << strerror(errno) << std::endl;
+            close(fd);
+            unlink(temporary.c_str());
+            return false;
+        }
+
+        // The file is zero-filled: padding, entry 0 of each array and empty index slots stay 0
+        char* base = static_cast<char*>(map);
+        std::memcpy(base, &header, sizeof(header));
+        char* blob = base + header.blob_offset;
+        auto* offsets = reinterpret_cast<uint64_t*>(base + header.offsets_offset);
+        auto* ranks = reinterpret_cast<uint32_t*>(base + header.ranks_offset);
+        auto* hashes = reinterpret_cast<uint64_t*>(base + header.hashes_offset);
+        auto* freqs = reinterpret_cast<uint32_t*>(base + header.doc_freqs_offset);
+        auto* index = reinterpret_cast<uint64_t*>(base + header.index_offset);
+        const size_t mask = header.index_slots - 1;
+
+        uint64_t cursor = 0;
+        for (size_t rank = 0; rank < terms; ++rank) {
+            const TermID id = order[rank];
+            const std::string_view term = vocabulary.Term(id);
+            std::memcpy(blob + cursor, term.data(), term.size());
+            offsets[rank] = cursor;
+            cursor += term.size();
+            ranks[id] = static_cast<uint32_t>(rank);
+
+            const uint64_t hash = vocabulary.Hash(id);
+            hashes[id] = hash;
+            freqs[id] = id < doc_freqs.size() ? doc_freqs[id] : 0;
+
+            size_t slot = hash & mask;
+            while (index[slot] != 0) slot = (slot + 1) & mask;
+            index[slot] = ((hash >> 32) << 32) | id;
+        }
+        offsets[terms] = cursor;
+
+        const bool synced = msync(map, header.file_bytes, MS_SYNC) == 0;
+        munmap(map, header.file_bytes);
+        close(fd);
+        // Readers of the old file keep their mapping; the new one replaces it atomically
+        if (!synced || rename(temporary.c_str(), path.c_str()) != 0) {
+            std::cerr << "WARN: cannot write vocabulary '" << path << "': " << strerror(errno) << std::endl;
+            unlink(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    TermID MappedVocabulary::Find(std::string_view term, uint64_t hash) const {
+        const uint64_t tag = hash >> 32;
+        // Write leaves half the slots empty; the cap only matters for a damaged index
+        size_t index = hash & m_index_mask;
+        for (size_t probes = 0; probes <= m_index_mask; ++probes, index = (index + 1) & m_index_mask) {
+            const uint64_t slot = m_index[index];
+            if (slot == 0) return 0;
+            const auto id = static_cast<TermID>(slot);
+            if ((slot >> 32) == tag && id != 0 && id <= m_size && Term(id) == term) return id;
+        }
+        return 0;
+    }
+
+} // namespace Hyperion
@@ -9,11 +9,8 @@ namespace Kernel {
 // Forward declaration of the trampoline entry
 void S_Entry();
 
-// Global pointer for the trampoline to find the function to run
-static std::function<void()>* g_next_task = nullptr;
-
 Fiber::Fiber(uint64_t id, std::string name, size_t stack_size) 
-    : id(id), name(name), stack_size(stack_size), is_completed(false) {
+    : id(id), stack_size(stack_size), name(name), is_completed(false) {
 
     // If stack_size is 0, it means this is the Main Thread wrapper. No allocation.
     if (stack_size == 0) {
@@ -54,6 +51,7 @@ void Scheduler::Init() {
     // ARCHITECTURAL NOTE:
     // The main thread is implicitly converted into fiber 0.
     // We do not allocate a stack for it; we simply capture its state during the first switch.
+    owner_thread = std::this_thread::get_id();
     main_fiber = new Fiber(0, "Main", 0);
     main_fiber->stack_base = nullptr; 
     current_fiber = main_fiber;
@@ -101,12 +99,6 @@ void Scheduler::Spawn(std::string name, std::function<void()> entry) {
     // This allows the Trampoline to retrieve the invocable without stack pointer manipulation complexities.
     auto* task_ptr = new std::function<void()>(entry);
     
-    // Static Thunk to bridge C-style function pointer to C++ Lambda
-    auto thunk = [](void* arg) {
-        auto* func = (std::function<void()>*)arg;
-        (*func)();
-    };
-    
     // Stack Layout Fabrication for Context Switch:
     // We mimic the stack frame that 'switch_context' expects to see when it restores a fiber.
     
@@ -193,8 +185,11 @@ void S_Entry() {
 void Scheduler::Yield() {
     Fiber* prev = current_fiber;
     
-    // Round Robin
-    current_idx = (current_idx + 1) % fibers.size();
+    // Round Robin over runnable fibers. If everything else is parked we land back on prev.
+    for (size_t n = 0; n < fibers.size(); ++n) {
+        current_idx = (current_idx + 1) % fibers.size();
+        if (!fibers[current_idx]->parked.load(std::memory_order_acquire)) break;
+    }
     current_fiber = fibers[current_idx];
     
     if (prev == current_fiber) return;
@@ -202,6 +197,16 @@ void Scheduler::Yield() {
     switch_context(&prev->stack_ptr, current_fiber->stack_ptr);
 }
 
+void Scheduler::Park() {
+    if (!current_fiber->parked.load(std::memory_order_acquire)) return;
+    Yield();
+    // Still parked: every fiber is, so Yield() came straight back. Let the OS run the
+    // thread that will unpark us instead of spinning on the caller's re-check.
+    if (current_fiber->parked.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
 void Scheduler::Run() {
     // Just yield loop
     while (true) {
@@ -8,11 +8,23 @@
 #include <clocale>
 #include <poll.h>
 #include <unistd.h>
+#include <thread>
 
 // Global context for Fibers
 Hyperion::ProcessingUnit* g_runtime = nullptr;
 bool g_running = true;
 
+// Allocator lock waiters past their spin budget: park the fiber if we are on the
+// scheduler thread (the holder may be a worker thread), otherwise yield the OS thread.
+void LockYield() {
+    auto& scheduler = Kernel::Scheduler::Get();
+    if (scheduler.IsSchedulerThread()) {
+        scheduler.Yield();
+    } else {
+        std::this_thread::yield();
+    }
+}
+
 // Graceful Exit
 void signal_handler(int) {
     g_running = false;
@@ -33,6 +45,10 @@ void UI_Fiber_Func() {
             char c;
             if (read(STDIN_FILENO, &c, 1) > 0) {
                 if (c == 'q') g_running = false;
+                // Point-in-time backup; ingest keeps appending while the image streams out
+                if (c == 'c') (void)Hyperion::Core::MemoryManager::instance().begin_checkpoint("ghost.ckpt");
+                // Allocator stats, fragmentation histogram and boundary-tag check
+                if (c == 'h' && g_runtime) g_runtime->DumpHeapReport("heap.report");
             }
         }
         
@@ -68,6 +84,7 @@ int main(int argc, char* argv[]) {
 
     // 2. Kernel Initialization
     Kernel::Scheduler::Get().Init();
+    Cognitron::Core::SetLockYieldHook(LockYield);
 
     // 3. Ghost Memory Boot (Explicit check before Engine start)
     auto& ghost = Hyperion::Core::MemoryManager::instance();
@@ -81,6 +98,11 @@ int main(int argc, char* argv[]) {
     Hyperion::ProcessingUnit runtime(argc, argv);
     g_runtime = &runtime;
 
+    if (runtime.GetConfig().run_benchmark) {
+        runtime.RunBenchmark();
+        return 0;
+    }
+
     if (!Hyperion::TUI::SystemMonitor::instance().initialize()) {
         std::cerr << "FATAL: TUI init failed." << std::endl;
         return 1;
@@ -1,9 +1,17 @@
+#include "math/Math.hpp"
+
 #include <cstdint>
 #include <cstddef>
 #include <cctype>
+#include <cmath>
+#include <algorithm>
+#include <bit>
+#include <cstring>
 
 #if defined(__aarch64__) || defined(_M_ARM64)
     #include <arm_neon.h>
+#elif defined(__x86_64__)
+    #include <immintrin.h>
 #endif
 
 namespace Hyperion::Math {
@@ -51,4 +59,539 @@ namespace Hyperion::Math {
         return accumulator;
     }
 
+    // --- Scalar Quantization ---
+
+    // Reciprocal step for [min, max] -> [0, levels]; 0 for a flat vector so every code is the lowest
+    static float QuantStep(float min_val, float max_val, float levels) {
+        const float range = max_val - min_val;
+        return range > 0.0f ? levels / range : 0.0f;
+    }
+
+    static QuantParams RangeParams(float min_val, float max_val, float levels) {
+        const float range = max_val - min_val;
+        return {range > 0.0f ? range / levels : 1.0f, min_val};
+    }
+
+    static void QuantizeTail(const float* src, int8_t* dst, size_t begin, size_t count, float min_val, float step) {
+        for (size_t i = begin; i < count; ++i) {
+            // nearbyint: ties-to-even under the default rounding mode, like cvtps / fcvtn
+            int code = static_cast<int>(std::nearbyint((src[i] - min_val) * step)) - 128;
+            dst[i] = static_cast<int8_t>(std::clamp(code, -128, 127));
+        }
+    }
+
+    static void MinMaxScalar(const float* data, size_t count, float& min_out, float& max_out) {
+        float lo = data[0];
+        float hi = data[0];
+        for (size_t i = 1; i < count; ++i) {
+            lo = std::min(lo, data[i]);
+            hi = std::max(hi, data[i]);
+        }
+        min_out = lo;
+        max_out = hi;
+    }
+
+    QuantParams QuantizeSQ8Scalar(const float* src, int8_t* dst, size_t count) {
+        if (count == 0) return {1.0f, 0.0f};
+        float min_val, max_val;
+        MinMaxScalar(src, count, min_val, max_val);
+        QuantizeTail(src, dst, 0, count, min_val, QuantStep(min_val, max_val, 255.0f));
+        return RangeParams(min_val, max_val, 255.0f);
+    }
+
+    QuantParams QuantizeSQ4(const float* src, uint8_t* dst, size_t count) {
+        if (count == 0) return {1.0f, 0.0f};
+        float min_val, max_val;
+        MinMax(src, count, min_val, max_val);
+        const float step = QuantStep(min_val, max_val, 15.0f);
+
+        auto code = [&](size_t i) {
+            return static_cast<uint8_t>(std::clamp(static_cast<int>(std::nearbyint((src[i] - min_val) * step)), 0, 15));
+        };
+        for (size_t i = 0; i + 1 < count; i += 2) {
+            dst[i / 2] = static_cast<uint8_t>(code(i) | (code(i + 1) << 4));
+        }
+        if (count & 1) dst[count / 2] = code(count - 1);
+        return RangeParams(min_val, max_val, 15.0f);
+    }
+
+    QuantParams QuantizeBinary(const float* src, uint8_t* dst, size_t count) {
+        if (count == 0) return {0.0f, 0.0f};
+        float sum = 0.0f;
+        for (size_t i = 0; i < count; ++i) sum += src[i];
+        const float mean = sum / static_cast<float>(count);
+
+        // Threshold at the mean: hashed TF vectors are non-negative, so a raw sign bit
+        // would carry nothing. The mean absolute deviation is the reconstruction step.
+        float spread = 0.0f;
+        std::fill(dst, dst + (count + 7) / 8, uint8_t{0});
+        for (size_t i = 0; i < count; ++i) {
+            spread += std::abs(src[i] - mean);
+            if (src[i] > mean) dst[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        }
+        return {spread / static_cast<float>(count), mean};
+    }
+
+    float L2Sqr(const float* a, const float* b, size_t count) {
+        // Four independent sums so -O3 vectorizes it on any ISA
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        size_t i = 0;
+        for (; i + 3 < count; i += 4) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                const float d = a[i + lane] - b[i + lane];
+                acc[lane] += d * d;
+            }
+        }
+        for (; i < count; ++i) {
+            const float d = a[i] - b[i];
+            acc[0] += d * d;
+        }
+        return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    }
+
+    // --- Distance Kernels: portable references (and the tails of the SIMD ones) ---
+
+    static float L2SqrSQ8Scalar(const float* query, const int8_t* codes, QuantParams params, size_t begin, size_t count) {
+        const float bias = params.bias + 128.0f * params.scale;
+        float acc = 0.0f;
+        for (size_t i = begin; i < count; ++i) {
+            const float d = query[i] - (static_cast<float>(codes[i]) * params.scale + bias);
+            acc += d * d;
+        }
+        return acc;
+    }
+
+    static float L2SqrSQ4Scalar(const float* query, const uint8_t* codes, QuantParams params, size_t begin, size_t count) {
+        float acc = 0.0f;
+        for (size_t i = begin; i < count; ++i) {
+            const uint8_t code = (codes[i / 2] >> ((i & 1) * 4)) & 0x0F;
+            const float d = query[i] - (static_cast<float>(code) * params.scale + params.bias);
+            acc += d * d;
+        }
+        return acc;
+    }
+
+    static uint32_t HammingScalar(const uint8_t* a, const uint8_t* b, size_t begin, size_t bytes) {
+        uint32_t distance = 0;
+        size_t i = begin;
+        for (; i + 7 < bytes; i += 8) {
+            uint64_t wa, wb;
+            std::memcpy(&wa, a + i, sizeof(wa));
+            std::memcpy(&wb, b + i, sizeof(wb));
+            distance += static_cast<uint32_t>(std::popcount(wa ^ wb));
+        }
+        for (; i < bytes; ++i) {
+            distance += static_cast<uint32_t>(std::popcount(static_cast<unsigned>(a[i] ^ b[i])));
+        }
+        return distance;
+    }
+
+    static float PQDistanceScalar(const float* table, const uint8_t* codes, size_t begin, size_t subspaces) {
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        size_t m = begin;
+        for (; m + 3 < subspaces; m += 4) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                acc[lane] += table[(m + lane) * PQ_CENTROIDS + codes[m + lane]];
+            }
+        }
+        for (; m < subspaces; ++m) acc[0] += table[m * PQ_CENTROIDS + codes[m]];
+        return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    }
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+    void MinMax(const float* data, size_t count, float& min_out, float& max_out) {
+        if (count < 4) {
+            MinMaxScalar(data, count, min_out, max_out);
+            return;
+        }
+        float32x4_t lo = vld1q_f32(data);
+        float32x4_t hi = lo;
+        size_t i = 4;
+        for (; i + 3 < count; i += 4) {
+            float32x4_t v = vld1q_f32(data + i);
+            lo = vminq_f32(lo, v);
+            hi = vmaxq_f32(hi, v);
+        }
+        min_out = vminvq_f32(lo);
+        max_out = vmaxvq_f32(hi);
+        for (; i < count; ++i) {
+            min_out = std::min(min_out, data[i]);
+            max_out = std::max(max_out, data[i]);
+        }
+    }
+
+    QuantParams QuantizeSQ8(const float* src, int8_t* dst, size_t count) {
+        if (count == 0) return {1.0f, 0.0f};
+        float min_val, max_val;
+        MinMax(src, count, min_val, max_val);
+        const float step = QuantStep(min_val, max_val, 255.0f);
+
+        const float32x4_t vmin = vdupq_n_f32(min_val);
+        const float32x4_t vstep = vdupq_n_f32(step);
+        const int32x4_t offset = vdupq_n_s32(128);
+
+        // 16 floats -> 16 codes: fcvtn (ties-to-even), then two saturating narrows
+        size_t i = 0;
+        for (; i + 15 < count; i += 16) {
+            int32x4_t q0 = vsubq_s32(vcvtnq_s32_f32(vmulq_f32(vsubq_f32(vld1q_f32(src + i), vmin), vstep)), offset);
+            int32x4_t q1 = vsubq_s32(vcvtnq_s32_f32(vmulq_f32(vsubq_f32(vld1q_f32(src + i + 4), vmin), vstep)), offset);
+            int32x4_t q2 = vsubq_s32(vcvtnq_s32_f32(vmulq_f32(vsubq_f32(vld1q_f32(src + i + 8), vmin), vstep)), offset);
+            int32x4_t q3 = vsubq_s32(vcvtnq_s32_f32(vmulq_f32(vsubq_f32(vld1q_f32(src + i + 12), vmin), vstep)), offset);
+            int16x8_t lo = vcombine_s16(vqmovn_s32(q0), vqmovn_s32(q1));
+            int16x8_t hi = vcombine_s16(vqmovn_s32(q2), vqmovn_s32(q3));
+            vst1q_s8(dst + i, vcombine_s8(vqmovn_s16(lo), vqmovn_s16(hi)));
+        }
+        QuantizeTail(src, dst, i, count, min_val, step);
+        return RangeParams(min_val, max_val, 255.0f);
+    }
+
+    float L2SqrSQ8(const float* query, const int8_t* codes, QuantParams params, size_t count) {
+        const float32x4_t vscale = vdupq_n_f32(params.scale);
+        const float32x4_t vbias = vdupq_n_f32(params.bias + 128.0f * params.scale);
+        float32x4_t acc = vdupq_n_f32(0.0f);
+
+        // 16 codes: sign-extend 8 -> 16 -> 32, convert, decode with one FMA
+        size_t i = 0;
+        for (; i + 15 < count; i += 16) {
+            int8x16_t c = vld1q_s8(codes + i);
+            int16x8_t c_lo = vmovl_s8(vget_low_s8(c));
+            int16x8_t c_hi = vmovl_s8(vget_high_s8(c));
+            float32x4_t v0 = vcvtq_f32_s32(vmovl_s16(vget_low_s16(c_lo)));
+            float32x4_t v1 = vcvtq_f32_s32(vmovl_s16(vget_high_s16(c_lo)));
+            float32x4_t v2 = vcvtq_f32_s32(vmovl_s16(vget_low_s16(c_hi)));
+            float32x4_t v3 = vcvtq_f32_s32(vmovl_s16(vget_high_s16(c_hi)));
+            float32x4_t d0 = vsubq_f32(vld1q_f32(query + i), vfmaq_f32(vbias, v0, vscale));
+            float32x4_t d1 = vsubq_f32(vld1q_f32(query + i + 4), vfmaq_f32(vbias, v1, vscale));
+            float32x4_t d2 = vsubq_f32(vld1q_f32(query + i + 8), vfmaq_f32(vbias, v2, vscale));
+            float32x4_t d3 = vsubq_f32(vld1q_f32(query + i + 12), vfmaq_f32(vbias, v3, vscale));
+            acc = vfmaq_f32(acc, d0, d0);
+            acc = vfmaq_f32(acc, d1, d1);
+            acc = vfmaq_f32(acc, d2, d2);
+            acc = vfmaq_f32(acc, d3, d3);
+        }
+        return vaddvq_f32(acc) + L2SqrSQ8Scalar(query, codes, params, i, count);
+    }
+
+    float L2SqrSQ4(const float* query, const uint8_t* codes, QuantParams params, size_t count) {
+        const float32x4_t vscale = vdupq_n_f32(params.scale);
+        const float32x4_t vbias = vdupq_n_f32(params.bias);
+        const uint8x8_t nibble = vdup_n_u8(0x0F);
+        float32x4_t acc = vdupq_n_f32(0.0f);
+
+        // 8 bytes -> 16 codes: split nibbles, zip back into element order, widen
+        size_t i = 0;
+        for (; i + 15 < count; i += 16) {
+            uint8x8_t packed = vld1_u8(codes + i / 2);
+            uint8x8x2_t zipped = vzip_u8(vand_u8(packed, nibble), vshr_n_u8(packed, 4));
+            uint16x8_t c_lo = vmovl_u8(zipped.val[0]);
+            uint16x8_t c_hi = vmovl_u8(zipped.val[1]);
+            float32x4_t v0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(c_lo)));
+            float32x4_t v1 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(c_lo)));
+            float32x4_t v2 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(c_hi)));
+            float32x4_t v3 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(c_hi)));
+            float32x4_t d0 = vsubq_f32(vld1q_f32(query + i), vfmaq_f32(vbias, v0, vscale));
+            float32x4_t d1 = vsubq_f32(vld1q_f32(query + i + 4), vfmaq_f32(vbias, v1, vscale));
+            float32x4_t d2 = vsubq_f32(vld1q_f32(query + i + 8), vfmaq_f32(vbias, v2, vscale));
+            float32x4_t d3 = vsubq_f32(vld1q_f32(query + i + 12), vfmaq_f32(vbias, v3, vscale));
+            acc = vfmaq_f32(acc, d0, d0);
+            acc = vfmaq_f32(acc, d1, d1);
+            acc = vfmaq_f32(acc, d2, d2);
+            acc = vfmaq_f32(acc, d3, d3);
+        }
+        return vaddvq_f32(acc) + L2SqrSQ4Scalar(query, codes, params, i, count);
+    }
+
+    uint32_t HammingDistance(const uint8_t* a, const uint8_t* b, size_t bytes) {
+        // cnt per byte, then a widening horizontal add per 16 bytes (at most 128, fits u16)
+        uint32_t distance = 0;
+        size_t i = 0;
+        for (; i + 15 < bytes; i += 16) {
+            uint8x16_t bits = vcntq_u8(veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+            distance += vaddlvq_u8(bits);
+        }
+        return distance + HammingScalar(a, b, i, bytes);
+    }
+
+    float PQDistance(const float* table, const uint8_t* codes, size_t subspaces) {
+        // Table lookups: NEON has no gather, the unrolled scalar loop is the fast path
+        return PQDistanceScalar(table, codes, 0, subspaces);
+    }
+
+    const char* QuantizeKernelName() { return "neon"; }
+
+#elif defined(__x86_64__)
+
+    // The default build targets baseline x86-64, so the wide kernels are compiled for
+    // their ISA with target attributes and picked once at runtime from CPUID.
+
+    __attribute__((target("avx2")))
+    static void MinMaxAVX2(const float* data, size_t count, float& min_out, float& max_out) {
+        __m256 lo = _mm256_loadu_ps(data);
+        __m256 hi = lo;
+        size_t i = 8;
+        for (; i + 7 < count; i += 8) {
+            __m256 v = _mm256_loadu_ps(data + i);
+            lo = _mm256_min_ps(lo, v);
+            hi = _mm256_max_ps(hi, v);
+        }
+        // Horizontal reduce: 8 -> 4 -> 2 -> 1
+        __m128 lo4 = _mm_min_ps(_mm256_castps256_ps128(lo), _mm256_extractf128_ps(lo, 1));
+        __m128 hi4 = _mm_max_ps(_mm256_castps256_ps128(hi), _mm256_extractf128_ps(hi, 1));
+        lo4 = _mm_min_ps(lo4, _mm_movehl_ps(lo4, lo4));
+        hi4 = _mm_max_ps(hi4, _mm_movehl_ps(hi4, hi4));
+        lo4 = _mm_min_ss(lo4, _mm_shuffle_ps(lo4, lo4, 1));
+        hi4 = _mm_max_ss(hi4, _mm_shuffle_ps(hi4, hi4, 1));
+        min_out = _mm_cvtss_f32(lo4);
+        max_out = _mm_cvtss_f32(hi4);
+        for (; i < count; ++i) {
+            min_out = std::min(min_out, data[i]);
+            max_out = std::max(max_out, data[i]);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static QuantParams QuantizeSQ8AVX2(const float* src, int8_t* dst, size_t count) {
+        if (count < 8) return QuantizeSQ8Scalar(src, dst, count);
+        float min_val, max_val;
+        MinMaxAVX2(src, count, min_val, max_val);
+        const float step = QuantStep(min_val, max_val, 255.0f);
+
+        const __m256 vmin = _mm256_set1_ps(min_val);
+        const __m256 vstep = _mm256_set1_ps(step);
+        const __m256i offset = _mm256_set1_epi32(128);
+        // packs works per 128-bit lane; this restores element order after both packs
+        const __m256i unshuffle = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        // 32 floats -> 32 codes: cvtps (ties-to-even), then saturating packs 32->16->8
+        size_t i = 0;
+        for (; i + 31 < count; i += 32) {
+            __m256i q0 = _mm256_sub_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(src + i), vmin), vstep)), offset);
+            __m256i q1 = _mm256_sub_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(src + i + 8), vmin), vstep)), offset);
+            __m256i q2 = _mm256_sub_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(src + i + 16), vmin), vstep)), offset);
+            __m256i q3 = _mm256_sub_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(src + i + 24), vmin), vstep)), offset);
+            __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(q0, q1), _mm256_packs_epi32(q2, q3));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permutevar8x32_epi32(packed, unshuffle));
+        }
+        QuantizeTail(src, dst, i, count, min_val, step);
+        return RangeParams(min_val, max_val, 255.0f);
+    }
+
+    // GCC 12's AVX-512 intrinsics seed their masked builtins with self-initialised
+    // "undefined" vectors, which -Wmaybe-uninitialized flags once inlined here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    __attribute__((target("avx512f")))
+    static QuantParams QuantizeSQ8AVX512(const float* src, int8_t* dst, size_t count) {
+        if (count < 16) return QuantizeSQ8Scalar(src, dst, count);
+
+        __m512 lo = _mm512_loadu_ps(src);
+        __m512 hi = lo;
+        size_t i = 16;
+        for (; i + 15 < count; i += 16) {
+            __m512 v = _mm512_loadu_ps(src + i);
+            lo = _mm512_min_ps(lo, v);
+            hi = _mm512_max_ps(hi, v);
+        }
+        float min_val = _mm512_reduce_min_ps(lo);
+        float max_val = _mm512_reduce_max_ps(hi);
+        for (; i < count; ++i) {
+            min_val = std::min(min_val, src[i]);
+            max_val = std::max(max_val, src[i]);
+        }
+        const float step = QuantStep(min_val, max_val, 255.0f);
+
+        const __m512 vmin = _mm512_set1_ps(min_val);
+        const __m512 vstep = _mm512_set1_ps(step);
+        const __m512i offset = _mm512_set1_epi32(128);
+
+        // 16 floats -> 16 codes: cvtps (ties-to-even), then one saturating narrow 32->8
+        i = 0;
+        for (; i + 15 < count; i += 16) {
+            __m512i q = _mm512_sub_epi32(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(src + i), vmin), vstep)), offset);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm512_cvtsepi32_epi8(q));
+        }
+        QuantizeTail(src, dst, i, count, min_val, step);
+        return RangeParams(min_val, max_val, 255.0f);
+    }
+#pragma GCC diagnostic pop
+
+    __attribute__((target("avx2")))
+    static float HorizontalSum(__m256 v) {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static float L2SqrSQ8AVX2(const float* query, const int8_t* codes, QuantParams params, size_t count) {
+        const __m256 vscale = _mm256_set1_ps(params.scale);
+        const __m256 vbias = _mm256_set1_ps(params.bias + 128.0f * params.scale);
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+
+        // 16 codes: sign-extend 8 -> 32, convert, decode with one FMA
+        size_t i = 0;
+        for (; i + 15 < count; i += 16) {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i));
+            __m256 v0 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(c));
+            __m256 v1 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(c, 8)));
+            __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(query + i), _mm256_fmadd_ps(v0, vscale, vbias));
+            __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(query + i + 8), _mm256_fmadd_ps(v1, vscale, vbias));
+            acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+            acc1 = _mm256_fmadd_ps(d1, d1, acc1);
+        }
+        return HorizontalSum(_mm256_add_ps(acc0, acc1)) + L2SqrSQ8Scalar(query, codes, params, i, count);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static float L2SqrSQ4AVX2(const float* query, const uint8_t* codes, QuantParams params, size_t count) {
+        const __m256 vscale = _mm256_set1_ps(params.scale);
+        const __m256 vbias = _mm256_set1_ps(params.bias);
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+
+        // 16 bytes -> 32 codes: split nibbles, interleave back into element order, widen
+        size_t i = 0;
+        for (; i + 31 < count; i += 32) {
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i / 2));
+            __m128i lo = _mm_and_si128(packed, nibble);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), nibble);
+            __m128i first = _mm_unpacklo_epi8(lo, hi);  // codes 0..15
+            __m128i second = _mm_unpackhi_epi8(lo, hi); // codes 16..31
+
+            const __m128i parts[4] = {first, _mm_srli_si128(first, 8), second, _mm_srli_si128(second, 8)};
+            for (size_t part = 0; part < 4; part += 2) {
+                __m256 v0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(parts[part]));
+                __m256 v1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(parts[part + 1]));
+                __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(query + i + part * 8), _mm256_fmadd_ps(v0, vscale, vbias));
+                __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(query + i + part * 8 + 8), _mm256_fmadd_ps(v1, vscale, vbias));
+                acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+                acc1 = _mm256_fmadd_ps(d1, d1, acc1);
+            }
+        }
+        return HorizontalSum(_mm256_add_ps(acc0, acc1)) + L2SqrSQ4Scalar(query, codes, params, i, count);
+    }
+
+    // Same loop as the scalar kernel, but compiled to the popcnt instruction
+    __attribute__((target("popcnt")))
+    static uint32_t HammingPopcnt(const uint8_t* a, const uint8_t* b, size_t bytes) {
+        uint64_t distance = 0;
+        size_t i = 0;
+        for (; i + 7 < bytes; i += 8) {
+            uint64_t wa, wb;
+            std::memcpy(&wa, a + i, sizeof(wa));
+            std::memcpy(&wb, b + i, sizeof(wb));
+            distance += static_cast<uint64_t>(__builtin_popcountll(wa ^ wb));
+        }
+        return static_cast<uint32_t>(distance) + HammingScalar(a, b, i, bytes);
+    }
+
+    __attribute__((target("avx2")))
+    static float PQDistanceAVX2(const float* table, const uint8_t* codes, size_t subspaces) {
+        // Eight subspaces per gather: lane k reads table[(m + k) * 256 + codes[m + k]]
+        const __m256i lane_rows = _mm256_setr_epi32(0, 256, 512, 768, 1024, 1280, 1536, 1792);
+        __m256 acc = _mm256_setzero_ps();
+        size_t m = 0;
+        for (; m + 7 < subspaces; m += 8) {
+            __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes + m)));
+            idx = _mm256_add_epi32(idx, lane_rows);
+            acc = _mm256_add_ps(acc, _mm256_i32gather_ps(table + m * PQ_CENTROIDS, idx, 4));
+        }
+        return HorizontalSum(acc) + PQDistanceScalar(table, codes, m, subspaces);
+    }
+
+    struct Kernels {
+        QuantParams (*quantize_sq8)(const float*, int8_t*, size_t);
+        const char* quantize_name;
+        bool avx2;
+        bool popcnt;
+    };
+
+    static Kernels SelectKernels() {
+        __builtin_cpu_init();
+        Kernels kernels{QuantizeSQ8Scalar, "scalar", false, __builtin_cpu_supports("popcnt") != 0};
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            kernels.avx2 = true;
+            kernels.quantize_sq8 = QuantizeSQ8AVX2;
+            kernels.quantize_name = "avx2";
+        }
+        if (__builtin_cpu_supports("avx512f")) {
+            kernels.quantize_sq8 = QuantizeSQ8AVX512;
+            kernels.quantize_name = "avx512";
+        }
+        return kernels;
+    }
+
+    static const Kernels& ActiveKernels() {
+        static const Kernels kernels = SelectKernels();
+        return kernels;
+    }
+
+    void MinMax(const float* data, size_t count, float& min_out, float& max_out) {
+        if (count >= 8 && ActiveKernels().avx2) {
+            MinMaxAVX2(data, count, min_out, max_out);
+        } else {
+            MinMaxScalar(data, count, min_out, max_out);
+        }
+    }
+
+    QuantParams QuantizeSQ8(const float* src, int8_t* dst, size_t count) {
+        return ActiveKernels().quantize_sq8(src, dst, count);
+    }
+
+    float L2SqrSQ8(const float* query, const int8_t* codes, QuantParams params, size_t count) {
+        if (ActiveKernels().avx2) return L2SqrSQ8AVX2(query, codes, params, count);
+        return L2SqrSQ8Scalar(query, codes, params, 0, count);
+    }
+
+    float L2SqrSQ4(const float* query, const uint8_t* codes, QuantParams params, size_t count) {
+        if (ActiveKernels().avx2) return L2SqrSQ4AVX2(query, codes, params, count);
+        return L2SqrSQ4Scalar(query, codes, params, 0, count);
+    }
+
+    uint32_t HammingDistance(const uint8_t* a, const uint8_t* b, size_t bytes) {
+        if (ActiveKernels().popcnt) return HammingPopcnt(a, b, bytes);
+        return HammingScalar(a, b, 0, bytes);
+    }
+
+    float PQDistance(const float* table, const uint8_t* codes, size_t subspaces) {
+        if (ActiveKernels().avx2) return PQDistanceAVX2(table, codes, subspaces);
+        return PQDistanceScalar(table, codes, 0, subspaces);
+    }
+
+    const char* QuantizeKernelName() { return ActiveKernels().quantize_name; }
+
+#else
+
+    void MinMax(const float* data, size_t count, float& min_out, float& max_out) {
+        MinMaxScalar(data, count, min_out, max_out);
+    }
+
+    QuantParams QuantizeSQ8(const float* src, int8_t* dst, size_t count) {
+        return QuantizeSQ8Scalar(src, dst, count);
+    }
+
+    float L2SqrSQ8(const float* query, const int8_t* codes, QuantParams params, size_t count) {
+        return L2SqrSQ8Scalar(query, codes, params, 0, count);
+    }
+
+    float L2SqrSQ4(const float* query, const uint8_t* codes, QuantParams params, size_t count) {
+        return L2SqrSQ4Scalar(query, codes, params, 0, count);
+    }
+
+    uint32_t HammingDistance(const uint8_t* a, const uint8_t* b, size_t bytes) {
+        return HammingScalar(a, b, 0, bytes);
+    }
+
+    float PQDistance(const float* table, const uint8_t* codes, size_t subspaces) {
+        return PQDistanceScalar(table, codes, 0, subspaces);
+    }
+
+    const char* QuantizeKernelName() { return "scalar"; }
+
+#endif
+
 } // namespace Hyperion::Math
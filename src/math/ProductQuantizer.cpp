@@ -0,0 +1,88 @@
+#include "math/ProductQuantizer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace Hyperion::Math {
+
+    ProductQuantizer::ProductQuantizer(size_t dim, size_t subspaces)
+        : m_dim(dim), m_subspaces(subspaces), m_sub_dim(dim / subspaces),
+          m_codebook(subspaces * PQ_CENTROIDS * (dim / subspaces), 0.0f) {}
+
+    ProductQuantizer::ProductQuantizer(size_t dim, size_t subspaces, std::span<const float> codebook)
+        : ProductQuantizer(dim, subspaces) {
+        std::copy_n(codebook.begin(), std::min(codebook.size(), m_codebook.size()), m_codebook.begin());
+    }
+
+    void ProductQuantizer::Train(const float* samples, size_t count, size_t iterations) {
+        if (count == 0) return;
+
+        // Seed with samples spread evenly over the set (deterministic; with fewer samples
+        // than centroids some centroids start as duplicates and simply stay unused)
+        for (size_t m = 0; m < m_subspaces; ++m) {
+            for (size_t c = 0; c < PQ_CENTROIDS; ++c) {
+                const float* sub = samples + (c * count / PQ_CENTROIDS) * m_dim + m * m_sub_dim;
+                std::copy_n(sub, m_sub_dim, Centroid(m, c));
+            }
+        }
+
+        std::vector<float> sums(PQ_CENTROIDS * m_sub_dim);
+        std::vector<uint32_t> counts(PQ_CENTROIDS);
+        for (size_t m = 0; m < m_subspaces; ++m) {
+            for (size_t iter = 0; iter < iterations; ++iter) {
+                std::fill(sums.begin(), sums.end(), 0.0f);
+                std::fill(counts.begin(), counts.end(), 0u);
+
+                // Assign
+                for (size_t i = 0; i < count; ++i) {
+                    const float* sub = samples + i * m_dim + m * m_sub_dim;
+                    const uint8_t c = Nearest(m, sub);
+                    counts[c]++;
+                    for (size_t d = 0; d < m_sub_dim; ++d) sums[c * m_sub_dim + d] += sub[d];
+                }
+
+                // Update (an empty cluster keeps its centroid)
+                for (size_t c = 0; c < PQ_CENTROIDS; ++c) {
+                    if (counts[c] == 0) continue;
+                    const float inv = 1.0f / static_cast<float>(counts[c]);
+                    float* centroid = Centroid(m, c);
+                    for (size_t d = 0; d < m_sub_dim; ++d) centroid[d] = sums[c * m_sub_dim + d] * inv;
+                }
+            }
+        }
+    }
+
+    uint8_t ProductQuantizer::Nearest(size_t m, const float* sub) const {
+        size_t best = 0;
+        float best_dist = std::numeric_limits<float>::max();
+        for (size_t c = 0; c < PQ_CENTROIDS; ++c) {
+            const float dist = L2Sqr(sub, Centroid(m, c), m_sub_dim);
+            if (dist < best_dist) {
+                best_dist = dist;
+                best = c;
+            }
+        }
+        return static_cast<uint8_t>(best);
+    }
+
+    void ProductQuantizer::Encode(const float* vec, uint8_t* codes) const {
+        for (size_t m = 0; m < m_subspaces; ++m) {
+            codes[m] = Nearest(m, vec + m * m_sub_dim);
+        }
+    }
+
+    void ProductQuantizer::Decode(const uint8_t* codes, float* out) const {
+        for (size_t m = 0; m < m_subspaces; ++m) {
+            std::copy_n(Centroid(m, codes[m]), m_sub_dim, out + m * m_sub_dim);
+        }
+    }
+
+    void ProductQuantizer::ComputeDistanceTable(const float* query, float* table) const {
+        for (size_t m = 0; m < m_subspaces; ++m) {
+            for (size_t c = 0; c < PQ_CENTROIDS; ++c) {
+                table[m * PQ_CENTROIDS + c] = L2Sqr(query + m * m_sub_dim, Centroid(m, c), m_sub_dim);
+            }
+        }
+    }
+
+} // namespace Hyperion::Math
@@ -1,11 +1,14 @@
 #include "mm/MemoryManager.hpp"
+#include "core/CpuRelax.hpp"
 #include <iostream>
 #include <sys/mman.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <cerrno>
 #include <cstring>
 #include <signal.h>
 #include <cstdlib>
+#include <algorithm>
 
 // ARCHITECTURAL NOTE:
 // This signal handler acts as a User-Space "Micro-Kernel" trap.
@@ -68,11 +71,15 @@ namespace Hyperion::Core {
         auto sig_res = install_signal_handlers();
         if (!sig_res) return std::unexpected(sig_res.error());
         
+        m_page_size = sysconf(_SC_PAGESIZE);
         m_running = true;
 
         // 3. Initialize/Load Header
         initialize_header();
 
+        // 4. Spawn the read-ahead worker
+        m_prefetch_thread = std::jthread([this](std::stop_token stop) { prefetch_worker(stop); });
+
         std::cout << "[MemoryManager] Systems Online. Ghost Mode Active." << std::endl;
         return {};
     }
@@ -82,6 +89,13 @@ namespace Hyperion::Core {
         
         std::cout << "[MemoryManager] Shutting down..." << std::endl;
         m_running = false;
+
+        // The workers may be mid-madvise/pwrite on the region; they must be gone before munmap.
+        if (m_prefetch_thread.joinable()) {
+            m_prefetch_thread.request_stop();
+            m_prefetch_thread.join();
+        }
+        wait_for_checkpoint();
         
         if (m_base_addr != MAP_FAILED && m_base_addr != nullptr) {
             munmap(m_base_addr, GHOST_SPACE_SIZE);
@@ -186,9 +200,26 @@ namespace Hyperion::Core {
         uintptr_t addr_val = (uintptr_t)fault_addr;
         size_t page_size = sysconf(_SC_PAGESIZE);
         uintptr_t page_addr = addr_val & ~(page_size - 1);
+
+        // 2. Copy-on-write checkpoint: the page is write-protected for an in-flight snapshot.
+        //    Save its pre-image first, then let the write through.
+        //    The trap announces itself before it reads the flag, and begin_checkpoint raises
+        //    the flag before it waits for announced commits (both seq_cst): either this trap
+        //    takes the checkpoint path, or the arming mprotect comes after its commit below.
+        m_commit_traps.fetch_add(1, std::memory_order_seq_cst);
+        if (m_checkpoint_active.load(std::memory_order_seq_cst) &&
+            page_addr >= m_checkpoint_begin && page_addr < m_checkpoint_end) {
+            m_checkpoint_traps.fetch_add(1, std::memory_order_seq_cst);
+            m_commit_traps.fetch_sub(1, std::memory_order_release);
+            const bool ok = handle_checkpoint_fault(page_addr);
+            m_checkpoint_traps.fetch_sub(1, std::memory_order_release);
+            return ok;
+        }
         
-        // 2. Materialize the page via mprotect(PROT_READ | PROT_WRITE)
-        if (mprotect((void*)page_addr, page_size, PROT_READ | PROT_WRITE) != 0) {
+        // 3. Materialize the page via mprotect(PROT_READ | PROT_WRITE)
+        const bool committed = mprotect((void*)page_addr, page_size, PROT_READ | PROT_WRITE) == 0;
+        m_commit_traps.fetch_sub(1, std::memory_order_release);
+        if (!committed) {
             std::cerr << "[MemoryManager] mprotect failed at " << (void*)page_addr 
                       << ": " << strerror(errno) << std::endl;
             return false;
@@ -200,4 +231,345 @@ namespace Hyperion::Core {
         return true;
     }
 
+    void MemoryManager::prefetch(size_t offset, size_t len) {
+        if (!m_running || len == 0 || offset >= GHOST_SPACE_SIZE) return;
+        len = std::min(len, GHOST_SPACE_SIZE - offset);
+
+        {
+            std::lock_guard<std::mutex> lock(m_prefetch_mutex);
+
+            // Sequential scans issue back-to-back windows; merge them into one request.
+            if (!m_prefetch_queue.empty()) {
+                PrefetchRequest& last = m_prefetch_queue.back();
+                if (offset >= last.offset && offset <= last.offset + last.len) {
+                    last.len = std::max(last.len, offset + len - last.offset);
+                    return;
+                }
+            }
+
+            if (m_prefetch_queue.size() >= PREFETCH_QUEUE_DEPTH) {
+                return; // Worker is behind; the faulting path still works without the hint.
+            }
+            m_prefetch_queue.push_back({offset, len});
+        }
+        m_prefetch_cv.notify_one();
+    }
+
+    void MemoryManager::prefetch_worker(std::stop_token stop) {
+        while (!stop.stop_requested()) {
+            PrefetchRequest req;
+            {
+                std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+                if (!m_prefetch_cv.wait(lock, stop, [this] { return !m_prefetch_queue.empty(); })) {
+                    return; // Stop requested
+                }
+                req = m_prefetch_queue.front();
+                m_prefetch_queue.pop_front();
+            }
+
+            uintptr_t base = reinterpret_cast<uintptr_t>(m_base_addr);
+            warm_range(base + req.offset, base + req.offset + req.len);
+        }
+    }
+
+    void MemoryManager::warm_range(uintptr_t begin, uintptr_t end) {
+        const size_t page_size = sysconf(_SC_PAGESIZE);
+        begin &= ~(page_size - 1);
+        end = (end + page_size - 1) & ~(page_size - 1);
+        if (begin >= end) return;
+
+        // Work in bounded chunks so a huge hint cannot monopolise the mmap lock.
+        constexpr size_t CHUNK_PAGES = 256;
+#if defined(__APPLE__)
+        char residency[CHUNK_PAGES];
+#else
+        unsigned char residency[CHUNK_PAGES];
+#endif
+
+        for (uintptr_t chunk = begin; chunk < end; chunk += CHUNK_PAGES * page_size) {
+            const size_t chunk_len = std::min<size_t>(CHUNK_PAGES * page_size, end - chunk);
+            const size_t pages = chunk_len / page_size;
+            void* addr = reinterpret_cast<void*>(chunk);
+
+            // Snapshot residency first so the resident counter only grows by pages we bring in.
+            size_t already_resident = 0;
+            if (mincore(addr, chunk_len, residency) == 0) {
+                for (size_t i = 0; i < pages; ++i) {
+                    already_resident += (residency[i] & 1);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_protect_mutex);
+
+            // Never unprotect pages an active checkpoint still has to copy. They sit below
+            // the log head and are committed already, so skipping the hint costs nothing.
+            if (m_checkpoint_active.load(std::memory_order_acquire) &&
+                chunk < m_checkpoint_end && chunk + chunk_len > m_checkpoint_begin) {
+                continue;
+            }
+
+            // 1. Commit: same transition the trap performs, but for the whole chunk at once.
+            if (mprotect(addr, chunk_len, PROT_READ | PROT_WRITE) != 0) {
+                return;
+            }
+
+            // 2. Populate: prefault writable PTEs in one syscall where the kernel supports it
+            //    (Linux 5.14+). Elsewhere, hint and then touch each page with a no-op atomic RMW,
+            //    which cannot clobber a concurrent writer on the same page.
+            bool populated = false;
+#if defined(MADV_POPULATE_WRITE)
+            populated = (madvise(addr, chunk_len, MADV_POPULATE_WRITE) == 0);
+#endif
+            if (!populated) {
+                madvise(addr, chunk_len, MADV_WILLNEED);
+                for (uintptr_t p = chunk; p < chunk + chunk_len; p += page_size) {
+                    __atomic_fetch_or(reinterpret_cast<uint8_t*>(p), uint8_t{0}, __ATOMIC_RELAXED);
+                }
+            }
+
+            const size_t warmed = pages - std::min(pages, already_resident);
+            m_prefetched_pages.fetch_add(warmed, std::memory_order_relaxed);
+            m_resident_pages.fetch_add(warmed, std::memory_order_relaxed);
+        }
+    }
+
+    // --- Copy-on-Write Checkpoints ---
+
+    std::expected<void, RuntimeError> MemoryManager::begin_checkpoint(const std::string& path,
+                                                                      size_t offset,
+                                                                      size_t length) {
+        if (!m_running || !m_base_addr) return std::unexpected(RuntimeError::InitializationFailed);
+        if (offset >= GHOST_SPACE_SIZE) return std::unexpected(RuntimeError::InvalidAccess);
+
+        std::lock_guard<std::mutex> lock(m_protect_mutex);
+        if (m_checkpoint_active.load(std::memory_order_acquire)) {
+            return std::unexpected(RuntimeError::CheckpointInProgress);
+        }
+        if (m_checkpoint_thread.joinable()) {
+            m_checkpoint_thread.join(); // Previous writer already finished; reap it
+        }
+
+        if (length == 0) {
+            // The commit thread advances the head concurrently (PublishRecords)
+            auto* header = static_cast<MemoryHeader*>(m_base_addr);
+            const uint64_t head = std::atomic_ref<uint64_t>(header->head_offset).load(std::memory_order_acquire);
+            length = head > offset ? head - offset : 0;
+        }
+        length = std::min(length, GHOST_SPACE_SIZE - offset);
+
+        uintptr_t base = reinterpret_cast<uintptr_t>(m_base_addr);
+        uintptr_t begin = (base + offset) & ~(m_page_size - 1);
+        uintptr_t end = (base + offset + length + m_page_size - 1) & ~(m_page_size - 1);
+        if (begin >= end) return std::unexpected(RuntimeError::InvalidAccess);
+
+        const size_t pages = (end - begin) / m_page_size;
+
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "[MemoryManager] Checkpoint open failed: " << strerror(errno) << std::endl;
+            return std::unexpected(RuntimeError::OperatingSystemError);
+        }
+
+        // Size the image up front: uncommitted pages are never written and stay zero-filled holes.
+        CheckpointHeader ckpt = { CHECKPOINT_MAGIC, m_page_size, begin - base, end - begin };
+        if (ftruncate(fd, static_cast<off_t>((pages + 1) * m_page_size)) != 0 ||
+            pwrite(fd, &ckpt, sizeof(ckpt), 0) != static_cast<ssize_t>(sizeof(ckpt))) {
+            close(fd);
+            return std::unexpected(RuntimeError::OperatingSystemError);
+        }
+
+        // Traps that read the previous checkpoint's flag may still be using its state; the
+        // flag is down, so once they are gone no trap looks at it until it goes up again
+        while (m_commit_traps.load(std::memory_order_seq_cst) != 0 ||
+               m_checkpoint_traps.load(std::memory_order_seq_cst) != 0) {
+            CpuRelax();
+        }
+
+        m_checkpoint_pages = std::make_unique<std::atomic<uint8_t>[]>(pages); // All PAGE_PENDING
+        m_checkpoint_uncommitted = std::make_unique<std::atomic<uint8_t>[]>(pages);
+
+        // Residency stands in for "committed", as in warm_range. Arming makes the whole range
+        // readable, so remember which pages were still PROT_NONE. A swapped-out page counts
+        // as uncommitted: it is still saved, and only costs one more trap afterwards.
+        {
+#if defined(__APPLE__)
+            std::vector<char> residency(pages);
+#else
+            std::vector<unsigned char> residency(pages);
+#endif
+            const bool known = mincore(reinterpret_cast<void*>(begin), end - begin, residency.data()) == 0;
+            for (size_t i = 0; i < pages; ++i) {
+                const bool resident = known && (residency[i] & 1);
+                m_checkpoint_uncommitted[i].store(resident ? 0 : 1, std::memory_order_relaxed);
+            }
+        }
+        m_checkpoint_fd = fd;
+        m_checkpoint_begin = begin;
+        m_checkpoint_end = end;
+        m_checkpoint_io_error.store(false, std::memory_order_relaxed);
+        m_checkpoint_armed.store(false, std::memory_order_relaxed);
+
+        // Arm the trap before protecting: any fault in the range from here on is a COW fault.
+        m_checkpoint_active.store(true, std::memory_order_seq_cst);
+
+        // A trap that read the flag just before it went up may still be committing a page;
+        // let it finish, so the mprotect below is the last protection change in the range.
+        while (m_commit_traps.load(std::memory_order_seq_cst) != 0) {
+            CpuRelax();
+        }
+
+        // THE CHECKPOINT INSTANT:
+        // Once this returns, no store can reach the range without the trap saving the page first.
+        if (mprotect(reinterpret_cast<void*>(begin), end - begin, PROT_READ) != 0) {
+            // Traps waiting for the arming commit their page once the flag drops
+            restore_checkpoint_protection();
+            m_checkpoint_active.store(false, std::memory_order_release);
+            close(fd);
+            m_checkpoint_fd = -1;
+            return std::unexpected(RuntimeError::OperatingSystemError);
+        }
+        m_checkpoint_armed.store(true, std::memory_order_release);
+
+        m_checkpoint_thread = std::jthread(&MemoryManager::checkpoint_writer, this);
+        return {};
+    }
+
+    void MemoryManager::wait_for_checkpoint() {
+        std::lock_guard<std::mutex> lock(m_protect_mutex);
+        if (m_checkpoint_thread.joinable()) {
+            m_checkpoint_thread.join();
+        }
+    }
+
+    // Runs inside the signal handler: only atomics, pwrite and mprotect from here down.
+    bool MemoryManager::handle_checkpoint_fault(uintptr_t page_addr) {
+        const int saved_errno = errno;
+        const size_t index = (page_addr - m_checkpoint_begin) / m_page_size;
+        std::atomic<uint8_t>& state = m_checkpoint_pages[index];
+
+        // Until the range is write-protected it may still hold PROT_NONE pages the copy
+        // cannot read. If arming fails instead, the flag drops with the old protections back.
+        while (!m_checkpoint_armed.load(std::memory_order_acquire)) {
+            if (!m_checkpoint_active.load(std::memory_order_acquire)) {
+                const bool ok = unprotect_checkpoint_page(page_addr, index);
+                errno = saved_errno;
+                return ok;
+            }
+            CpuRelax();
+        }
+
+        uint8_t expected = PAGE_PENDING;
+        if (state.compare_exchange_strong(expected, PAGE_COPYING, std::memory_order_acq_rel)) {
+            save_checkpoint_page(index);
+            m_cow_faults.fetch_add(1, std::memory_order_relaxed);
+            const bool ok = unprotect_checkpoint_page(page_addr, index);
+            errno = saved_errno;
+            return ok;
+        }
+
+        // The writer thread is copying this page right now; its pre-image is safe once SAVED.
+        while (state.load(std::memory_order_acquire) != PAGE_SAVED) {
+            CpuRelax();
+        }
+
+        // Saving put the page back to its pre-arming protection; unlocking again is idempotent.
+        const bool ok = unprotect_checkpoint_page(page_addr, index);
+        errno = saved_errno;
+        return ok;
+    }
+
+    // Signal-safe. The faulting access needs the page writable. For a page that was never
+    // committed this is the ghost trap's commit, so it is counted once, by whoever clears
+    // the flag.
+    bool MemoryManager::unprotect_checkpoint_page(uintptr_t page_addr, size_t index) {
+        if (mprotect(reinterpret_cast<void*>(page_addr), m_page_size, PROT_READ | PROT_WRITE) != 0) return false;
+        if (m_checkpoint_uncommitted[index].exchange(0, std::memory_order_acq_rel) != 0) {
+            m_fault_count.fetch_add(1, std::memory_order_relaxed);
+            m_resident_pages.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Arming failed part-way: committed pages back to read-write, the rest to PROT_NONE
+    void MemoryManager::restore_checkpoint_protection() {
+        const size_t pages = (m_checkpoint_end - m_checkpoint_begin) / m_page_size;
+        for (size_t run = 0; run < pages;) {
+            const bool uncommitted = m_checkpoint_uncommitted[run].load(std::memory_order_relaxed) != 0;
+            size_t next = run + 1;
+            while (next < pages && (m_checkpoint_uncommitted[next].load(std::memory_order_relaxed) != 0) == uncommitted) {
+                ++next;
+            }
+            mprotect(reinterpret_cast<void*>(m_checkpoint_begin + run * m_page_size), (next - run) * m_page_size,
+                     uncommitted ? PROT_NONE : PROT_READ | PROT_WRITE);
+            run = next;
+        }
+    }
+
+    void MemoryManager::save_checkpoint_page(size_t index) {
+        const uintptr_t page_addr = m_checkpoint_begin + index * m_page_size;
+        const off_t file_offset = static_cast<off_t>((index + 1) * m_page_size);
+
+        // An uncommitted page reads as zeros through the armed PROT_READ mapping. If it still
+        // is all zeros, the hole already holds it; otherwise (swapped out, not uncommitted) it
+        // is written like any other page.
+        const bool uncommitted = m_checkpoint_uncommitted[index].load(std::memory_order_acquire) != 0;
+        bool zero = uncommitted;
+        for (size_t i = 0; zero && i < m_page_size / sizeof(uint64_t); ++i) {
+            zero = reinterpret_cast<const uint64_t*>(page_addr)[i] == 0;
+        }
+
+        // pwrite reads the page through the kernel; EFAULT means there is nothing to copy
+        size_t written = zero ? m_page_size : 0;
+        while (written < m_page_size) {
+            ssize_t n = pwrite(m_checkpoint_fd, reinterpret_cast<const char*>(page_addr) + written,
+                               m_page_size - written, file_offset + static_cast<off_t>(written));
+            if (n > 0) {
+                written += static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                if (errno != EFAULT) m_checkpoint_io_error.store(true, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        // Back to the protection it had before arming: the ghost trap still owns a page that
+        // was never committed (and counts it when it is)
+        mprotect(reinterpret_cast<void*>(page_addr), m_page_size,
+                 uncommitted ? PROT_NONE : PROT_READ | PROT_WRITE);
+        m_checkpoint_pages[index].store(PAGE_SAVED, std::memory_order_release);
+    }
+
+    void MemoryManager::checkpoint_writer() {
+        const size_t pages = (m_checkpoint_end - m_checkpoint_begin) / m_page_size;
+
+        // Sweep in address order; pages the trap already claimed are skipped.
+        for (size_t i = 0; i < pages; ++i) {
+            uint8_t expected = PAGE_PENDING;
+            if (m_checkpoint_pages[i].compare_exchange_strong(expected, PAGE_COPYING,
+                                                              std::memory_order_acq_rel)) {
+                save_checkpoint_page(i);
+            }
+        }
+
+        // Trap-side copies may still be in flight on other threads.
+        for (size_t i = 0; i < pages; ++i) {
+            while (m_checkpoint_pages[i].load(std::memory_order_acquire) != PAGE_SAVED) {
+                std::this_thread::yield();
+            }
+        }
+
+        fsync(m_checkpoint_fd);
+        close(m_checkpoint_fd);
+        m_checkpoint_fd = -1;
+
+        if (m_checkpoint_io_error.load(std::memory_order_relaxed)) {
+            std::cerr << "[MemoryManager] Checkpoint image incomplete: I/O error" << std::endl;
+        }
+
+        // The page-state array stays allocated until the next checkpoint, which waits for
+        // traps that observed the old flag to finish with it.
+        m_checkpoint_active.store(false, std::memory_order_release);
+    }
+
 }
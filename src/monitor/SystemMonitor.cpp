@@ -129,6 +129,16 @@ namespace Hyperion::TUI {
         ss_stats << "FAULTS: " << ghost.get_page_fault_count() 
                  << " | RESIDENT: " << ghost.get_resident_pages()
                  << " | FIBERS: " << Kernel::Scheduler::Get().AllFibers().size();
+        if (ghost.checkpoint_active()) {
+            ss_stats << " | CKPT COW: " << ghost.get_checkpoint_cow_faults();
+        }
+        if (m_heap_valid) {
+            ss_stats << " | HEAP: " << (m_heap_in_use >> 10) << "K used, "
+                     << (m_heap_largest_free >> 20) << "M max free, "
+                     << static_cast<int>(m_heap_fragmentation * 100.0) << "% frag, "
+                     << m_heap_lock_contended << " waits (max " << (m_heap_lock_max_wait_ns / 1000) << "us)";
+            if (!m_heap_tags_ok) ss_stats << " [CORRUPT]";
+        }
         draw_text(2, m_height - 1, ss_stats.str());
 
 
@@ -426,6 +436,18 @@ namespace Hyperion::TUI {
     void SystemMonitor::update_ghost_stats(size_t faults, size_t resident) { 
         m_page_faults = faults; m_resident_pages = resident; 
     }
+    void SystemMonitor::update_heap_stats(size_t in_use, size_t free_bytes, size_t largest_free,
+                                          double fragmentation, size_t lock_contended, size_t lock_max_wait_ns,
+                                          bool tags_ok) {
+        m_heap_valid = true;
+        m_heap_in_use = in_use;
+        m_heap_free = free_bytes;
+        m_heap_largest_free = largest_free;
+        m_heap_fragmentation = fragmentation;
+        m_heap_lock_contended = lock_contended;
+        m_heap_lock_max_wait_ns = lock_max_wait_ns;
+        m_heap_tags_ok = tags_ok;
+    }
     void SystemMonitor::update_simd_lanes(const float*) { } 
     void SystemMonitor::update_memory_view(const void* ptr, size_t size) {
         if (!ptr || size == 0) return;
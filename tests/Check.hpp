@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// Minimal assertion helpers for the unit tests: a failed CHECK reports the expression
+// and location and keeps going, so one run lists every failure; main returns
+// TestResult() as its exit code.
+
+namespace Hyperion::Test {
+
+    inline int& FailureCount() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void ReportFailure(const char* expression, const char* file, int line) {
+        std::cerr << file << ":" << line << ": CHECK failed: " << expression << std::endl;
+        ++FailureCount();
+    }
+
+    inline int TestResult() {
+        if (FailureCount() != 0) {
+            std::cerr << FailureCount() << " check(s) failed" << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+} // namespace Hyperion::Test
+
+#define CHECK(expression) \
+    ((expression) ? (void)0 : ::Hyperion::Test::ReportFailure(#expression, __FILE__, __LINE__))
+
+#define CHECK_EQ(actual, expected) CHECK((actual) == (expected))
@@ -0,0 +1,147 @@
+// MPMCQueue and MPSCQueue: full and empty boundaries, FIFO order across many laps of
+// the ring, swapping pops and peek(), and under contention every element delivered
+// exactly once with each producer's elements seen in order by every consumer.
+
+#include "core/LockFreeQueue.hpp"
+#include "Check.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Hyperion::Core;
+
+namespace {
+
+    constexpr size_t CAPACITY = 8;
+
+    // A Vyukov ring holds all Capacity slots; one more push fails until a pop
+    template <typename Queue>
+    void TestFullAndEmpty() {
+        Queue queue;
+        CHECK(!queue.pop().has_value());
+        int out = -1;
+        CHECK(!queue.pop(out));
+        CHECK_EQ(out, -1);
+
+        for (int i = 0; i < static_cast<int>(CAPACITY); ++i) CHECK(queue.push(i));
+        CHECK(!queue.push(99));
+        CHECK_EQ(queue.size_approx(), CAPACITY);
+
+        CHECK_EQ(queue.pop().value_or(-1), 0);
+        CHECK(queue.push(8));
+        CHECK(!queue.push(99));
+        for (int i = 1; i <= static_cast<int>(CAPACITY); ++i) CHECK_EQ(queue.pop().value_or(-1), i);
+        CHECK(!queue.pop().has_value());
+        CHECK_EQ(queue.size_approx(), 0u);
+    }
+
+    // Fill levels from 1 to Capacity, for many laps: positions wrap the slot array
+    // at every offset and order is kept
+    template <typename Queue>
+    void TestWrapAround() {
+        Queue queue;
+        int next_in = 0, next_out = 0;
+        for (int round = 0; round < 1000; ++round) {
+            const int fill = 1 + round % static_cast<int>(CAPACITY);
+            for (int i = 0; i < fill; ++i) CHECK(queue.push(next_in++));
+            for (int i = 0; i < fill; ++i) {
+                int out = -1;
+                CHECK(queue.pop(out));
+                CHECK_EQ(out, next_out);
+                ++next_out;
+            }
+            CHECK(!queue.pop().has_value());
+        }
+    }
+
+    // pop(T&) swaps, so the caller's buffer goes back into the ring and comes round again
+    void TestSwappingPop() {
+        MPSCQueue<std::string, CAPACITY> queue;
+        CHECK(queue.peek() == nullptr);
+        CHECK(queue.push(std::string("first")));
+        CHECK(queue.push("second")); // Assigned into the slot
+        CHECK(queue.peek() != nullptr && *queue.peek() == "first");
+
+        std::string out = "spare";
+        CHECK(queue.pop(out));
+        CHECK(out == "first");
+        CHECK(queue.peek() != nullptr && *queue.peek() == "second");
+        CHECK(queue.pop().value_or("") == "second");
+        CHECK(queue.peek() == nullptr);
+
+        MPMCQueue<std::vector<int>, CAPACITY> buffers;
+        for (int lap = 0; lap < 3 * static_cast<int>(CAPACITY); ++lap) {
+            CHECK(buffers.push(std::vector<int>(static_cast<size_t>(lap % 4), lap)));
+            std::vector<int> taken(100, -1);
+            CHECK(buffers.pop(taken));
+            CHECK(taken == std::vector<int>(static_cast<size_t>(lap % 4), lap));
+        }
+        CHECK(!buffers.pop().has_value());
+    }
+
+    constexpr size_t PRODUCERS = 4;
+    constexpr uint32_t PER_PRODUCER = 200000;
+
+    uint64_t Encode(size_t producer, uint32_t sequence) { return (uint64_t{producer} << 32) | sequence; }
+
+    // Producers push (producer, sequence) pairs; each consumer checks that sequences
+    // from one producer only increase, and 'seen' counts every delivery
+    template <typename Queue>
+    void RunContended(size_t consumers) {
+        Queue queue;
+        std::vector<std::atomic<uint8_t>> seen(PRODUCERS * PER_PRODUCER);
+        std::atomic<size_t> delivered{0};
+        std::atomic<size_t> out_of_order{0};
+
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < PRODUCERS; ++p) {
+            threads.emplace_back([&queue, p] {
+                for (uint32_t i = 0; i < PER_PRODUCER; ++i) {
+                    while (!queue.push(Encode(p, i))) std::this_thread::yield();
+                }
+            });
+        }
+        for (size_t c = 0; c < consumers; ++c) {
+            threads.emplace_back([&] {
+                std::vector<int64_t> last(PRODUCERS, -1);
+                while (delivered.load(std::memory_order_relaxed) < PRODUCERS * PER_PRODUCER) {
+                    const auto item = queue.pop();
+                    if (!item) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    const size_t producer = *item >> 32;
+                    const auto sequence = static_cast<uint32_t>(*item);
+                    if (static_cast<int64_t>(sequence) <= last[producer]) out_of_order++;
+                    last[producer] = sequence;
+                    seen[producer * PER_PRODUCER + sequence].fetch_add(1, std::memory_order_relaxed);
+                    delivered.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        size_t once = 0;
+        for (auto& count : seen) once += count.load() == 1;
+        CHECK_EQ(once, seen.size());
+        CHECK_EQ(delivered.load(), seen.size());
+        CHECK_EQ(out_of_order.load(), 0u);
+        CHECK(!queue.pop().has_value());
+    }
+
+} // namespace
+
+int main() {
+    TestFullAndEmpty<MPMCQueue<int, CAPACITY>>();
+    TestFullAndEmpty<MPSCQueue<int, CAPACITY>>();
+    TestWrapAround<MPMCQueue<int, CAPACITY>>();
+    TestWrapAround<MPSCQueue<int, CAPACITY>>();
+    TestSwappingPop();
+    RunContended<MPMCQueue<uint64_t, 64>>(3);
+    RunContended<MPMCQueue<uint64_t, 2>>(2);
+    RunContended<MPSCQueue<uint64_t, 64>>(1);
+    return Hyperion::Test::TestResult();
+}
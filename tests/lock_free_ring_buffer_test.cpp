@@ -0,0 +1,175 @@
+// LockFreeRingBuffer: DYNAMIC_CAPACITY rounding, partial bulk pushes and pops at the
+// full and empty boundaries, claims that stop at the physical end of the ring, and a
+// producer and a consumer thread moving items in place through claim / commit, with
+// claims and commits of every size, so every item arrives once and in order.
+
+#include "core/LockFreeRingBuffer.hpp"
+#include "Check.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Hyperion::Core;
+
+namespace {
+
+    constexpr size_t SLOTS = 8;
+    using Ring = LockFreeRingBuffer<int, SLOTS>;
+
+    // Pushes one at a time until full: the number of items the ring holds
+    template <typename Buffer>
+    size_t FillCount(Buffer& ring) {
+        size_t count = 0;
+        while (ring.push(static_cast<int>(count))) ++count;
+        return count;
+    }
+
+    // The slot count is rounded up to a power of 2 (at least 2); one slot stays empty
+    void TestDynamicCapacity() {
+        const std::array<std::pair<size_t, size_t>, 8> cases = {{
+            {0, 2}, {1, 2}, {2, 2}, {3, 4}, {5, 8}, {8, 8}, {9, 16}, {1000, 1024},
+        }};
+        for (const auto& [requested, slots] : cases) {
+            LockFreeRingBuffer<int, DYNAMIC_CAPACITY> ring(requested);
+            CHECK_EQ(ring.capacity(), slots);
+            CHECK_EQ(ring.free_slots(), slots - 1);
+            CHECK_EQ(FillCount(ring), slots - 1);
+            CHECK_EQ(ring.size_approx(), slots - 1);
+            CHECK_EQ(ring.free_slots(), 0u);
+        }
+        Ring fixed;
+        CHECK_EQ(fixed.capacity(), SLOTS);
+        CHECK_EQ(FillCount(fixed), SLOTS - 1);
+    }
+
+    // Bulk calls take what fits and report it; the rest of the input is left alone
+    void TestPartialBulk() {
+        Ring ring;
+        std::vector<int> input(20);
+        std::iota(input.begin(), input.end(), 0);
+
+        CHECK_EQ(ring.try_push_n(input.begin(), 5), 5u);
+        CHECK_EQ(ring.try_push_n(input.begin() + 5, 10), SLOTS - 1 - 5); // Nearly full
+        CHECK_EQ(ring.try_push_n(input.begin(), 3), 0u);
+        CHECK_EQ(ring.free_slots(), 0u);
+
+        std::vector<int> out(3, -1);
+        CHECK_EQ(ring.try_pop_n(out), 3u);
+        CHECK(out == (std::vector<int>{0, 1, 2}));
+
+        out.assign(10, -1);
+        CHECK_EQ(ring.try_pop_n(out), SLOTS - 1 - 3); // Nearly empty
+        CHECK(std::equal(out.begin(), out.begin() + 4, input.begin() + 3));
+        CHECK(out[4] == -1);
+        CHECK_EQ(ring.try_pop_n(out), 0u);
+
+        // Head and tail now sit at slot 7: a full batch crosses the end, in two pieces
+        CHECK_EQ(ring.try_push_n(std::vector<int>{10, 11, 12, 13, 14, 15, 16, 17}), SLOTS - 1);
+        out.assign(SLOTS, -1);
+        CHECK_EQ(ring.try_pop_n(out), SLOTS - 1);
+        CHECK(out == (std::vector<int>{10, 11, 12, 13, 14, 15, 16, -1}));
+    }
+
+    // A claim stops at the physical end of the ring and the next one starts at slot 0;
+    // only committed slots are seen on the other side, and only the claimed part commits
+    void TestClaimsStopAtTheEnd() {
+        Ring ring;
+        for (int i = 0; i < 6; ++i) CHECK(ring.push(i));
+        for (int i = 0; i < 6; ++i) CHECK_EQ(ring.pop().value_or(-1), i);
+
+        auto first = ring.claim_push(5);
+        CHECK_EQ(first.size(), 2u); // Slots 6 and 7
+        first[0] = 100;
+        first[1] = 101;
+        CHECK_EQ(ring.size_approx(), 0u);
+        ring.commit_push(2);
+
+        auto second = ring.claim_push(5);
+        CHECK_EQ(second.size(), 5u); // Slots 0..4; slot 5 stays empty
+        for (size_t i = 0; i < second.size(); ++i) second[i] = 102 + static_cast<int>(i);
+        ring.commit_push(3);  // Two claimed slots handed back
+        CHECK_EQ(ring.size_approx(), 5u);
+        CHECK_EQ(ring.free_slots(), 2u);
+
+        auto read = ring.claim_pop(SLOTS);
+        CHECK(read.size() == 2 && read[0] == 100 && read[1] == 101);
+        ring.commit_pop(1);
+        read = ring.claim_pop(SLOTS);
+        CHECK(read.size() == 1 && read[0] == 101); // The uncommitted slot is claimed again
+        ring.commit_pop(5); // Capped at the claim
+        read = ring.claim_pop(SLOTS);
+        CHECK(read.size() == 3 && read[0] == 102 && read[2] == 104);
+        ring.commit_pop(read.size());
+        CHECK(ring.claim_pop(SLOTS).empty());
+        ring.commit_pop(0);
+        CHECK(!ring.pop().has_value());
+    }
+
+    constexpr uint64_t ITEMS = 1'000'000;
+
+    // One producer and one consumer claim and commit random amounts, so claims wrap the
+    // end at every offset; each item carries its sequence number
+    template <typename Buffer>
+    void RunClaimCommit(Buffer& ring) {
+        std::atomic<size_t> wraps{0};
+        std::thread producer([&] {
+            std::mt19937 rng(5);
+            const uint64_t* last = nullptr;
+            size_t wrapped = 0;
+            for (uint64_t next = 0; next < ITEMS;) {
+                auto slots = ring.claim_push(1 + rng() % 13);
+                if (slots.empty()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                wrapped += last != nullptr && slots.data() < last; // Back at slot 0
+                last = slots.data();
+                const size_t commit = std::min<uint64_t>(1 + rng() % slots.size(), ITEMS - next);
+                for (size_t i = 0; i < commit; ++i) slots[i] = next++;
+                ring.commit_push(commit);
+            }
+            wraps = wrapped;
+        });
+
+        std::mt19937 rng(9);
+        uint64_t expected = 0;
+        size_t gaps = 0;
+        while (expected < ITEMS) {
+            auto slots = ring.claim_pop(1 + rng() % 11);
+            if (slots.empty()) {
+                std::this_thread::yield();
+                continue;
+            }
+            const size_t commit = 1 + rng() % slots.size();
+            for (size_t i = 0; i < commit; ++i) gaps += slots[i] != expected++;
+            ring.commit_pop(commit);
+        }
+        producer.join();
+        CHECK_EQ(gaps, 0u);
+        CHECK(wraps.load() > ITEMS / ring.capacity() / 2);
+        CHECK_EQ(ring.size_approx(), 0u);
+    }
+
+    void TestTwoThreads() {
+        LockFreeRingBuffer<uint64_t, 64> fixed;
+        RunClaimCommit(fixed);
+        LockFreeRingBuffer<uint64_t, DYNAMIC_CAPACITY> dynamic(12); // 16 slots
+        RunClaimCommit(dynamic);
+    }
+
+} // namespace
+
+int main() {
+    TestDynamicCapacity();
+    TestPartialBulk();
+    TestClaimsStopAtTheEnd();
+    TestTwoThreads();
+    return Hyperion::Test::TestResult();
+}
@@ -0,0 +1,118 @@
+// RollingHash, WordNGrams and CharShingles: the modular arithmetic agrees with 128-bit
+// division, and every feature hash produced by sliding the window equals the one a
+// fresh instance computes from that window alone (no token or byte ever leaves it).
+
+#include "core/NGram.hpp"
+#include "Check.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Hyperion;
+
+namespace {
+
+    using RH = RollingHash;
+
+    void TestArithmetic() {
+        std::mt19937_64 rng(3);
+        for (int i = 0; i < 200000; ++i) {
+            const uint64_t a = rng() % RH::PRIME, b = rng() % RH::PRIME, x = rng();
+            CHECK_EQ(RH::Mul(a, b), static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % RH::PRIME));
+            CHECK_EQ(RH::Reduce(x), x % RH::PRIME);
+            CHECK_EQ(RH::Add(a, b), (a + b) % RH::PRIME);
+            CHECK_EQ(RH::Add(RH::Sub(a, b), b), a);
+        }
+        CHECK_EQ(RH::Mul(RH::PRIME - 1, RH::PRIME - 1), 1u);
+        const uint64_t base = RH::Base(7);
+        CHECK_EQ(RH::Pow(base, 0), 1u);
+        CHECK_EQ(RH::Pow(base, 5), RH::Mul(RH::Mul(RH::Mul(RH::Mul(base, base), base), base), base));
+    }
+
+    // Order-n hash of tokens[end + 1 - n, end], from a fresh WordNGrams: its last emit
+    std::vector<uint64_t> FreshNGram(const std::vector<uint64_t>& tokens, size_t end, size_t n, uint64_t seed) {
+        WordNGrams fresh(n, seed);
+        std::vector<uint64_t> emitted;
+        for (size_t i = end + 1 - n; i <= end; ++i) {
+            emitted.clear();
+            fresh.Push(tokens[i], [&](uint64_t hash) { emitted.push_back(hash); });
+        }
+        return emitted;
+    }
+
+    void TestWordNGramsMatchFromScratch() {
+        std::mt19937_64 rng(11);
+        for (size_t order = 2; order <= MAX_NGRAM; ++order) {
+            const uint64_t seed = rng();
+            // Random tokens, then a run of one repeated token
+            std::vector<uint64_t> tokens;
+            for (int i = 0; i < 200; ++i) tokens.push_back(rng());
+            for (int i = 0; i < 20; ++i) tokens.push_back(42);
+
+            WordNGrams grams(order, seed);
+            CHECK(grams.Enabled());
+            for (size_t end = 0; end < tokens.size(); ++end) {
+                std::vector<uint64_t> emitted;
+                grams.Push(tokens[end], [&](uint64_t hash) { emitted.push_back(hash); });
+                // Orders 2..order, shortest first, once enough tokens have been seen
+                const size_t expected = end + 1 < 2 ? 0 : std::min(order, end + 1) - 1;
+                CHECK_EQ(emitted.size(), expected);
+                for (size_t k = 0; k < emitted.size(); ++k) {
+                    const size_t n = k + 2;
+                    const std::vector<uint64_t> fresh = FreshNGram(tokens, end, n, seed);
+                    CHECK(!fresh.empty() && fresh.back() == emitted[k]);
+                }
+            }
+
+            // After Reset nothing spans the boundary: the first token emits nothing
+            grams.Reset();
+            size_t count = 0;
+            grams.Push(tokens[0], [&](uint64_t) { ++count; });
+            CHECK_EQ(count, 0u);
+        }
+        CHECK(!WordNGrams(1).Enabled());
+    }
+
+    // Hash of text[begin, begin + width) from a fresh CharShingles: its only emit
+    std::vector<uint64_t> FreshShingle(const std::string& text, size_t begin, size_t width, uint64_t seed) {
+        CharShingles fresh(width, seed);
+        std::vector<uint64_t> emitted;
+        for (size_t i = begin; i < begin + width; ++i) {
+            fresh.Push(static_cast<unsigned char>(text[i]), [&](uint64_t hash) { emitted.push_back(hash); });
+        }
+        return emitted;
+    }
+
+    void TestCharShinglesMatchFromScratch() {
+        std::mt19937_64 rng(17);
+        for (size_t width : std::vector<size_t>{2, 3, 5, 8, 17, 31, MAX_SHINGLE}) {
+            const uint64_t seed = rng();
+            // Random bytes over the whole range, then a run of one repeated byte
+            std::string text;
+            for (int i = 0; i < 300; ++i) text.push_back(static_cast<char>(rng()));
+            text.append(80, 'a');
+
+            CharShingles shingles(width, seed);
+            CHECK(shingles.Enabled());
+            std::vector<uint64_t> emitted;
+            for (char c : text) shingles.Push(static_cast<unsigned char>(c), [&](uint64_t hash) { emitted.push_back(hash); });
+            CHECK_EQ(emitted.size(), text.size() - width + 1);
+            for (size_t begin = 0; begin < emitted.size(); ++begin) {
+                const std::vector<uint64_t> fresh = FreshShingle(text, begin, width, seed);
+                CHECK(fresh.size() == 1 && fresh[0] == emitted[begin]);
+            }
+        }
+        CHECK(!CharShingles(1).Enabled());
+        CHECK(CharShingles(MAX_SHINGLE * 2).Enabled()); // Clamped, not disabled
+    }
+
+} // namespace
+
+int main() {
+    TestArithmetic();
+    TestWordNGramsMatchFromScratch();
+    TestCharShinglesMatchFromScratch();
+    return Hyperion::Test::TestResult();
+}
@@ -0,0 +1,146 @@
+// Fiber parking: a queue with FiberParkWait consumed from a fiber and fed by an OS
+// thread. The waiting fiber leaves the round robin while other fibers keep running,
+// every item arrives in order, and a wait that ends never leaves the fiber flagged as
+// parked, including when Park() returns early because every fiber was parked.
+
+#include "kernel/Scheduler.hpp"
+#include "core/LockFreeRingBuffer.hpp"
+#include "core/WaitStrategy.hpp"
+#include "Check.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Hyperion::Core;
+
+namespace {
+
+    using FiberQueue = LockFreeRingBuffer<int, 16, FiberParkWait>;
+
+    constexpr int ITEMS = 2000;
+
+    // Fibers outlive the test that spawned them, so what they touch afterwards is global
+    std::atomic<int> g_resumed{0};
+
+    [[noreturn]] void IdleForever() {
+        for (;;) {
+            g_resumed++;
+            Kernel::Scheduler::Get().Yield();
+        }
+    }
+
+    // Pushes 1..ITEMS, pausing now and then so the consumer drains the queue and parks
+    std::thread StartProducer(FiberQueue& queue) {
+        return std::thread([&queue] {
+            for (int i = 1; i <= ITEMS; ++i) {
+                while (!queue.push(i)) std::this_thread::yield();
+                if (i % 100 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+
+    // Pops ITEMS items, waiting on the queue whenever it is empty; false on a gap
+    bool ConsumeAll(FiberQueue& queue, const std::atomic<bool>& running) {
+        bool in_order = true;
+        for (int expected = 1; expected <= ITEMS;) {
+            if (auto item = queue.pop()) {
+                in_order &= *item == expected;
+                ++expected;
+            } else {
+                queue.wait(running);
+            }
+        }
+        return in_order;
+    }
+
+    // Only the main fiber exists: each Park() comes straight back, and the wait still
+    // has to end unflagged, whether the condition turns true without a Notify() or a
+    // producer catches up
+    void TestEveryFiberParked() {
+        auto& sched = Kernel::Scheduler::Get();
+
+        FiberParkWait wait;
+        std::atomic<bool> flag{false};
+        std::thread setter([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            flag = true;
+        });
+        wait.Wait([&] { return flag.load(); });
+        setter.join();
+        CHECK(flag.load());
+        CHECK(!sched.Current()->parked.load());
+
+        FiberQueue queue;
+        std::atomic<bool> running{true};
+        std::thread producer = StartProducer(queue);
+        CHECK(ConsumeAll(queue, running));
+        producer.join();
+        CHECK(!sched.Current()->parked.load());
+    }
+
+    // A producer thread wakes a consumer fiber; meanwhile the main fiber keeps being
+    // scheduled, and the consumer is scheduled again once it is done
+    void TestProducerWakesFiber() {
+        auto& sched = Kernel::Scheduler::Get();
+        FiberQueue queue;
+        std::atomic<bool> running{true};
+        std::atomic<bool> consumed{false};
+        std::atomic<bool> in_order{false};
+        Kernel::Fiber* consumer = nullptr;
+
+        sched.Spawn("consumer", [&] {
+            consumer = sched.Current();
+            in_order = ConsumeAll(queue, running);
+            consumed = true;
+            IdleForever();
+        });
+
+        std::thread producer = StartProducer(queue);
+        size_t main_turns = 0;
+        while (!consumed) {
+            sched.Yield();
+            ++main_turns;
+        }
+        producer.join();
+        CHECK(in_order);
+        CHECK(main_turns > 0);
+        CHECK(consumer != nullptr && !consumer->parked.load());
+
+        // Not skipped by the round robin after its last wait
+        const int before = g_resumed.load();
+        for (int i = 0; i < 10; ++i) sched.Yield();
+        CHECK(g_resumed.load() > before);
+    }
+
+    // Wake() gets a parked fiber out although its condition never holds
+    void TestWakeEndsWait() {
+        auto& sched = Kernel::Scheduler::Get();
+        FiberParkWait wait;
+        std::atomic<bool> returned{false};
+        Kernel::Fiber* waiter = nullptr;
+
+        sched.Spawn("waiter", [&] {
+            waiter = sched.Current();
+            wait.Wait([] { return false; });
+            returned = true;
+            IdleForever();
+        });
+
+        for (int i = 0; i < 10; ++i) sched.Yield();
+        CHECK(!returned);
+        CHECK(waiter != nullptr && waiter->parked.load());
+        std::thread([&] { wait.Wake(); }).join();
+        while (!returned) sched.Yield();
+        CHECK(!waiter->parked.load());
+    }
+
+} // namespace
+
+int main() {
+    Kernel::Scheduler::Get().Init();
+    TestEveryFiberParked();
+    TestProducerWakesFiber();
+    TestWakeEndsWait();
+    return Hyperion::Test::TestResult();
+}
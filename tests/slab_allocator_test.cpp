@@ -0,0 +1,316 @@
+// SlabAllocator: random alloc/free across both tiers, span reclaim and release, and
+// cross-thread frees, each followed by a WalkHeap() consistency check.
+
+#include "memory/SlabAllocator.hpp"
+#include "Check.hpp"
+
+#include <barrier>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace Cognitron::Core;
+
+namespace {
+
+    constexpr uint64_t HEAP_OFFSET = 1ULL << 20;
+    constexpr size_t HEAP_INITIAL = 8ULL << 20;
+    constexpr size_t HEAP_RESERVE = 256ULL << 20;
+
+    struct Region {
+        char* base;
+        Region() {
+            void* map = mmap(nullptr, HEAP_RESERVE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            base = map == MAP_FAILED ? nullptr : static_cast<char*>(map);
+        }
+        ~Region() {
+            if (base) munmap(base, HEAP_RESERVE);
+        }
+    };
+
+    struct Allocation {
+        uint64_t offset;
+        size_t size;
+        uint8_t fill;
+    };
+
+    void Fill(SlabAllocator& heap, const Allocation& a) {
+        std::memset(heap.GetPtr<char>(a.offset), a.fill, a.size);
+    }
+
+    // Every byte still holds its fill: no other allocation overlapped it
+    bool Intact(SlabAllocator& heap, const Allocation& a) {
+        const auto* bytes = heap.GetPtr<uint8_t>(a.offset);
+        for (size_t i = 0; i < a.size; ++i) {
+            if (bytes[i] != a.fill) return false;
+        }
+        return true;
+    }
+
+    void CheckHeap(SlabAllocator& heap) {
+        HeapReport report = heap.WalkHeap();
+        CHECK(report.Valid());
+        if (!report.Valid()) std::cerr << "  corruption: " << report.corruption << std::endl;
+        CHECK_EQ(report.span_blocks, report.stats.spans);
+        CHECK_EQ(report.used_bytes + report.free_bytes, report.stats.heap_bytes);
+    }
+
+    void CheckDrained(SlabAllocator& heap) {
+        SlabStats stats = heap.GetStats();
+        CHECK_EQ(stats.small_in_use_bytes, 0u);
+        CHECK_EQ(stats.large_in_use_bytes, 0u);
+        CHECK_EQ(stats.small_allocs, stats.small_frees);
+        CHECK_EQ(stats.large_allocs, stats.large_frees);
+    }
+
+    void TestRandomChurn(BlockLayout layout) {
+        Region region;
+        SlabAllocator heap(region.base, HEAP_INITIAL, HEAP_OFFSET, layout, HEAP_RESERVE);
+        std::mt19937_64 rng(42);
+        std::vector<Allocation> live;
+
+        for (int op = 0; op < 200000; ++op) {
+            if (live.empty() || rng() % 100 < 55) {
+                const uint64_t pick = rng() % 100;
+                size_t size = pick < 80 ? 1 + rng() % SMALL_MAX_SIZE : SMALL_MAX_SIZE + 1 + rng() % (60 * 1024);
+                size_t alignment = pick % 10 == 0 ? size_t{1} << (6 + rng() % 7) : 0;
+                Allocation a{heap.Allocate(size, alignment), size, static_cast<uint8_t>(rng())};
+                CHECK(a.offset != 0);
+                if (a.offset == 0) break;
+                if (alignment != 0) CHECK_EQ(a.offset % alignment, 0u);
+                Fill(heap, a);
+                live.push_back(a);
+            } else {
+                const size_t victim = rng() % live.size();
+                CHECK(Intact(heap, live[victim]));
+                heap.Free(live[victim].offset);
+                live[victim] = live.back();
+                live.pop_back();
+            }
+            if (op % 20000 == 0) CheckHeap(heap);
+        }
+
+        for (const Allocation& a : live) {
+            CHECK(Intact(heap, a));
+            heap.Free(a.offset);
+        }
+        CheckHeap(heap);
+        CheckDrained(heap);
+    }
+
+    // A refill keeps one completely free span and hands the others back to the heap
+    void TestSpanRelease() {
+        Region region;
+        SlabAllocator heap(region.base, HEAP_INITIAL, HEAP_OFFSET, BlockLayout::CacheLine, HEAP_RESERVE);
+        constexpr size_t PER_SPAN = (SPAN_SIZE - sizeof(SpanHeader)) / 64;
+        constexpr size_t SPANS = 10;
+
+        std::vector<uint64_t> objects;
+        for (size_t i = 0; i < PER_SPAN * SPANS; ++i) objects.push_back(heap.Allocate(64));
+        CHECK_EQ(heap.GetStats().spans, SPANS);
+
+        for (uint64_t offset : objects) heap.Free(offset);
+        CHECK_EQ(heap.GetStats().spans, SPANS); // Nothing is released on the free path
+
+        // Exhausting the current span makes the refill look at the queued spans
+        objects.clear();
+        for (size_t i = 0; i < PER_SPAN + 1; ++i) objects.push_back(heap.Allocate(64));
+        CHECK_EQ(heap.GetStats().spans, 2u);
+        CheckHeap(heap);
+
+        for (uint64_t offset : objects) heap.Free(offset);
+        CheckHeap(heap);
+        CheckDrained(heap);
+    }
+
+    // Compact heaps serve small objects from 16-byte classes; alignment is still honoured
+    void TestCompactSmallClasses() {
+        constexpr size_t OBJECTS = 1000000;
+        uint64_t span_bytes[2] = {};
+        for (BlockLayout layout : {BlockLayout::CacheLine, BlockLayout::Compact}) {
+            Region region;
+            SlabAllocator heap(region.base, HEAP_INITIAL, HEAP_OFFSET, layout, HEAP_RESERVE);
+            std::vector<uint64_t> objects;
+            for (size_t i = 0; i < OBJECTS; ++i) objects.push_back(heap.Allocate(24));
+            span_bytes[layout == BlockLayout::Compact] = heap.GetStats().spans * SPAN_SIZE;
+
+            for (size_t alignment : {16, 32, 64}) {
+                for (size_t size = 1; size <= SMALL_MAX_SIZE; size += 7) {
+                    uint64_t offset = heap.Allocate(size, alignment);
+                    CHECK_EQ(offset % alignment, 0u);
+                    heap.Free(offset);
+                }
+            }
+            for (uint64_t offset : objects) heap.Free(offset);
+            CheckHeap(heap);
+            CheckDrained(heap);
+        }
+
+        // 24-byte objects: 64 bytes each in the CacheLine layout, 32 in the Compact one
+        const double cacheline = static_cast<double>(span_bytes[0]) / OBJECTS;
+        const double compact = static_cast<double>(span_bytes[1]) / OBJECTS;
+        CHECK(cacheline >= 64.0 && cacheline < 65.0);
+        CHECK(compact >= 32.0 && compact < 33.0);
+    }
+
+    // A heap in a shared file mapping is reattached as-is by the next instance, even at
+    // another address: roots, live objects and the small tier all carry over
+    void TestReopenFromFile() {
+        char path[] = "/tmp/slab_allocator_test.XXXXXX";
+        int fd = mkstemp(path);
+        CHECK(fd >= 0);
+        if (fd < 0) return;
+        unlink(path);
+        CHECK_EQ(ftruncate(fd, HEAP_RESERVE), 0);
+        auto map = [fd] {
+            void* base = mmap(nullptr, HEAP_RESERVE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            return base == MAP_FAILED ? nullptr : static_cast<char*>(base);
+        };
+
+        std::vector<Allocation> live;
+        char* first = map();
+        {
+            SlabAllocator heap(first, HEAP_INITIAL, HEAP_OFFSET, BlockLayout::CacheLine, HEAP_RESERVE);
+            CHECK(!heap.WasReopened());
+            for (size_t size : {24, 100, 4096, 5000, 1 << 20}) {
+                live.push_back({heap.Allocate(size), size, static_cast<uint8_t>(size)});
+                Fill(heap, live.back());
+            }
+            heap.SetRoot(0, live.back().offset);
+        }
+        char* second = map(); // Mapped while the first view still exists: a new address
+        munmap(first, HEAP_RESERVE);
+        {
+            SlabAllocator heap(second, HEAP_INITIAL, HEAP_OFFSET, BlockLayout::CacheLine, HEAP_RESERVE);
+            CHECK(heap.WasReopened());
+            CHECK_EQ(heap.GetRoot(0), live.back().offset);
+            CheckHeap(heap);
+            for (const Allocation& a : live) {
+                CHECK(Intact(heap, a));
+                heap.Free(a.offset);
+            }
+            CheckHeap(heap);
+            CheckDrained(heap);
+        }
+        {
+            // A different geometry is not the same heap: formatted from scratch
+            SlabAllocator heap(second, HEAP_INITIAL, HEAP_OFFSET, BlockLayout::Compact, HEAP_RESERVE);
+            CHECK(!heap.WasReopened());
+            CHECK_EQ(heap.GetRoot(0), 0u);
+        }
+        munmap(second, HEAP_RESERVE);
+        close(fd);
+    }
+
+    // Objects freed by another thread are reused by their owner instead of new spans
+    void TestRemoteFreesAreReclaimed() {
+        Region region;
+        SlabAllocator heap(region.base, HEAP_INITIAL, HEAP_OFFSET, BlockLayout::CacheLine, HEAP_RESERVE);
+        constexpr size_t BATCH = 5000;
+        constexpr int ROUNDS = 20;
+        std::vector<uint64_t> handoff(BATCH);
+        std::barrier sync(2);
+
+        std::jthread owner([&] {
+            for (int round = 0; round < ROUNDS; ++round) {
+                for (size_t i = 0; i < BATCH; ++i) handoff[i] = heap.Allocate(128);
+                sync.arrive_and_wait();
+                sync.arrive_and_wait();
+            }
+        });
+        std::jthread freer([&] {
+            for (int round = 0; round < ROUNDS; ++round) {
+                sync.arrive_and_wait();
+                for (uint64_t offset : handoff) heap.Free(offset);
+                sync.arrive_and_wait();
+            }
+        });
+        owner.join();
+        freer.join();
+
+        // One batch needs 10 spans; the owner must keep recycling them
+        const size_t batch_spans = (BATCH + (SPAN_SIZE - sizeof(SpanHeader)) / 128 - 1) /
+                                   ((SPAN_SIZE - sizeof(SpanHeader)) / 128);
+        CHECK(heap.GetStats().spans <= batch_spans + 2);
+        CheckHeap(heap);
+        CheckDrained(heap);
+    }
+
+    // Every thread allocates and frees a random mix of its own and other threads' objects
+    void TestConcurrentChurn() {
+        Region region;
+        SlabAllocator heap(region.base, HEAP_INITIAL, HEAP_OFFSET, BlockLayout::CacheLine, HEAP_RESERVE);
+        constexpr int THREADS = 4;
+        std::mutex pool_lock;
+        std::vector<Allocation> pool;
+
+        // GetStats() is lock-free and may run while the heap grows
+        std::atomic<bool> churning{true};
+        std::jthread monitor([&] {
+            uint64_t heap_bytes = 0;
+            while (churning.load(std::memory_order_relaxed)) {
+                SlabStats stats = heap.GetStats();
+                CHECK(stats.heap_bytes >= heap_bytes && stats.heap_bytes <= stats.reserve_bytes);
+                heap_bytes = stats.heap_bytes;
+                std::this_thread::yield();
+            }
+        });
+
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&, t] {
+                std::mt19937_64 rng(t + 1);
+                for (int op = 0; op < 50000; ++op) {
+                    if (rng() % 100 < 55) {
+                        size_t size = rng() % 8 == 0 ? 8192 : 1 + rng() % 1024;
+                        Allocation a{heap.Allocate(size), size, static_cast<uint8_t>(rng())};
+                        CHECK(a.offset != 0);
+                        Fill(heap, a);
+                        std::lock_guard guard(pool_lock);
+                        pool.push_back(a);
+                    } else {
+                        Allocation a;
+                        {
+                            std::lock_guard guard(pool_lock);
+                            if (pool.empty()) continue;
+                            const size_t victim = rng() % pool.size();
+                            a = pool[victim];
+                            pool[victim] = pool.back();
+                            pool.pop_back();
+                        }
+                        CHECK(Intact(heap, a));
+                        heap.Free(a.offset);
+                    }
+                }
+            });
+        }
+        threads.clear();
+        churning.store(false, std::memory_order_relaxed);
+        monitor.join();
+        CHECK(heap.GetStats().grows > 0);
+
+        CheckHeap(heap);
+        for (const Allocation& a : pool) {
+            CHECK(Intact(heap, a));
+            heap.Free(a.offset);
+        }
+        CheckHeap(heap);
+        CheckDrained(heap);
+    }
+
+} // namespace
+
+int main() {
+    TestRandomChurn(BlockLayout::CacheLine);
+    TestRandomChurn(BlockLayout::Compact);
+    TestSpanRelease();
+    TestCompactSmallClasses();
+    TestReopenFromFile();
+    TestRemoteFreesAreReclaimed();
+    TestConcurrentChurn();
+    return Hyperion::Test::TestResult();
+}
@@ -0,0 +1,161 @@
+// UTF-8 tokenization: strict decoding of malformed input, case folding, word classes,
+// the SIMD scanner against a code-point-at-a-time reference, and Tokenizer on top.
+
+#include "core/Tokenizer.hpp"
+#include "core/TokenScanner.hpp"
+#include "core/Unicode.hpp"
+#include "Check.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Hyperion;
+
+namespace {
+
+    std::vector<std::string> Scan(std::string_view text) {
+        std::vector<std::string> tokens;
+        TokenScanner scanner(text);
+        for (std::string_view token; scanner.Next(token);) tokens.emplace_back(token);
+        return tokens;
+    }
+
+    // One code point at a time: decode, classify, fold
+    std::vector<std::string> Reference(std::string_view text) {
+        std::vector<std::string> tokens;
+        std::pmr::string current;
+        auto flush = [&] {
+            if (!current.empty()) tokens.emplace_back(current);
+            current.clear();
+        };
+        for (size_t i = 0; i < text.size();) {
+            size_t length;
+            const char32_t cp = Unicode::Decode(text.data() + i, text.size() - i, length);
+            i += length;
+            switch (Unicode::Classify(cp)) {
+                case Unicode::WordClass::Separator: flush(); break;
+                case Unicode::WordClass::Ideograph: flush(); Unicode::Append(current, Unicode::Fold(cp)); flush(); break;
+                case Unicode::WordClass::Word: Unicode::Append(current, Unicode::Fold(cp)); break;
+            }
+        }
+        flush();
+        return tokens;
+    }
+
+    void CheckDecode(std::string_view bytes, char32_t expected, size_t expected_length) {
+        size_t length = 0;
+        CHECK_EQ(Unicode::Decode(bytes.data(), bytes.size(), length), expected);
+        CHECK_EQ(length, expected_length);
+    }
+
+    void TestDecodeMalformed() {
+        CheckDecode("A", U'A', 1);
+        CheckDecode("\xC3\xA9", U'é', 2);
+        CheckDecode("\xE2\x82\xAC", U'€', 3);
+        CheckDecode("\xF0\x9F\x98\x80", U'\U0001F600', 4);
+
+        // Each malformed form is one REPLACEMENT of one byte, so decoding resynchronises
+        const char32_t bad = Unicode::REPLACEMENT;
+        CheckDecode("\x80", bad, 1);                 // Stray continuation
+        CheckDecode("\xBF\x80", bad, 1);
+        CheckDecode("\xC0\x80", bad, 1);             // Overlong NUL
+        CheckDecode("\xC1\xBF", bad, 1);             // Overlong 2-byte
+        CheckDecode("\xE0\x80\x80", bad, 1);         // Overlong 3-byte
+        CheckDecode("\xF0\x80\x80\x80", bad, 1);     // Overlong 4-byte
+        CheckDecode("\xED\xA0\x80", bad, 1);         // UTF-16 surrogate
+        CheckDecode("\xF4\x90\x80\x80", bad, 1);     // Past U+10FFFF
+        CheckDecode("\xF5\x80\x80\x80", bad, 1);
+        CheckDecode("\xFF", bad, 1);
+        CheckDecode("\xC3", bad, 1);                 // Truncated at the end of input
+        CheckDecode("\xE2\x82", bad, 1);
+        CheckDecode("\xE2\x82" "A", bad, 1);         // Truncated before an ASCII byte
+        CheckDecode("\xF0\x9F\x98", bad, 1);
+    }
+
+    void TestMalformedBytesSeparate() {
+        CHECK(Scan("ab\xC3" "cd") == (std::vector<std::string>{"ab", "cd"}));
+        CHECK(Scan("ab\x80" "cd") == (std::vector<std::string>{"ab", "cd"}));
+        CHECK(Scan("caf\xC3\xA9\xFF" "bar") == (std::vector<std::string>{"caf\xC3\xA9", "bar"}));
+        CHECK(Scan("\xED\xA0\x80surrogate\xC0\x80") == (std::vector<std::string>{"surrogate"}));
+        CHECK(Scan("\xF0\x9F\x98") == std::vector<std::string>{});
+        // A valid multi-byte letter split across a 64-byte block boundary stays whole
+        const std::string padded = std::string(63, 'x') + " \xC3\x89t\xC3\xA9";
+        CHECK(Scan(padded) == (std::vector<std::string>{std::string(63, 'x'), "\xC3\xA9t\xC3\xA9"}));
+    }
+
+    void TestCaseFolding() {
+        CHECK_EQ(Unicode::Fold(U'Ä'), U'ä');   // Ä
+        CHECK_EQ(Unicode::Fold(U'İ'), U'i');   // İ: dotless fold, so "İstanbul" matches "istanbul"
+        CHECK_EQ(Unicode::Fold(U'ß'), U'ß');   // ß -> ss changes length: unchanged
+        CHECK_EQ(Unicode::Fold(U'Σ'), U'σ');   // Σ
+        CHECK_EQ(Unicode::Fold(U'ς'), U'σ');   // Final ς
+        CHECK_EQ(Unicode::Fold(U'М'), U'м');   // М
+        CHECK_EQ(Unicode::Fold(U'Ա'), U'ա');   // Armenian Ա
+        CHECK_EQ(Unicode::Fold(U'Ａ'), U'a');        // Fullwidth Ａ
+        CHECK_EQ(Unicode::Fold(U'１'), U'1');        // Fullwidth １
+
+        CHECK(Scan("Größe GRÖSSE straße") == (std::vector<std::string>{"größe", "grösse", "straße"}));
+        CHECK(Scan("Привет, МИР!") == (std::vector<std::string>{"привет", "мир"}));
+        CHECK(Scan("ΣΊΣΥΦΟΣ σίσυφος") == (std::vector<std::string>{"σίσυφοσ", "σίσυφοσ"}));
+        CHECK(Scan("ＡＢＣ１２ abc12") == (std::vector<std::string>{"abc12", "abc12"}));
+        CHECK(Scan("Hello, World! 123abc") == (std::vector<std::string>{"hello", "world", "123abc"}));
+    }
+
+    void TestWordClasses() {
+        CHECK(Scan("中文字") == (std::vector<std::string>{"中", "文", "字"}));
+        CHECK(Scan("ひらがな") == (std::vector<std::string>{"ひ", "ら", "が", "な"}));
+        CHECK(Scan("カタカナ") == (std::vector<std::string>{"カタカナ"}));
+        CHECK(Scan("a😀b c—d") == (std::vector<std::string>{"a", "b", "c", "d"}));
+        CHECK(Scan("cafe\xCC\x81 naïve") == (std::vector<std::string>{"cafe\xCC\x81", "naïve"})); // Combining mark
+    }
+
+    // Random mixes of scripts, malformed bytes and long ASCII runs
+    void TestScannerMatchesReference() {
+        const char* pieces[] = {
+            "Hello", " ", "world", ", ", "Straße", "ÄÖÜ", "Привет", "МИР", "中文字", "ひらがな",
+            "カタカナ", "😀", "—", "Ωμέγα", "ＡＢＣ１２", "\xC3", "\x80", "\xF0\x9F", "e\xCC\x81",
+            "İstanbul", "\n", "1234", "x"
+        };
+        std::mt19937 rng(9);
+        size_t mismatches = 0;
+        for (int iteration = 0; iteration < 20000; ++iteration) {
+            std::string text;
+            const int mode = rng() % 3;
+            const size_t length = rng() % 400;
+            while (text.size() < length) {
+                if (mode == 0) {
+                    text.push_back(static_cast<char>(rng()));
+                } else {
+                    text += pieces[rng() % std::size(pieces)];
+                }
+                if (mode == 2) text += std::string(rng() % 70, 'a');
+            }
+            if (Scan(text) != Reference(text)) ++mismatches;
+        }
+        CHECK_EQ(mismatches, 0u);
+    }
+
+    void TestTokenizerCounts() {
+        ConcurrentVocabulary shared(DEFAULT_FEATURE_SEED);
+        Tokenizer tokenizer(shared);
+        const TermCounts counts = tokenizer.Tokenize("The ÜBER über Über of straße \xFF STRASSE");
+        CHECK_EQ(counts.size(), 3u); // "the" and "of" are stopwords
+        CHECK_EQ(counts.at(shared.Find("über")), 3);
+        CHECK_EQ(counts.at(shared.Find("straße")), 1);
+        CHECK_EQ(counts.at(shared.Find("strasse")), 1);
+        CHECK_EQ(tokenizer.VocabularySize(), shared.size());
+        CHECK(tokenizer.GetTerm(shared.Find("über")) == "über");
+    }
+
+} // namespace
+
+int main() {
+    TestDecodeMalformed();
+    TestMalformedBytesSeparate();
+    TestCaseFolding();
+    TestWordClasses();
+    TestScannerMatchesReference();
+    TestTokenizerCounts();
+    return Hyperion::Test::TestResult();
+}
@@ -0,0 +1,204 @@
+// MappedVocabulary: a saved vocabulary round-trips (terms, hashes, ids, document
+// frequencies) and can be layered under a live one; files with a damaged header are
+// rejected, and damaged entries give empty terms or misses, never a bad read or a hang.
+
+#include "core/VocabularyFile.hpp"
+#include "core/FeatureHash.hpp"
+#include "Check.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace Hyperion;
+
+namespace {
+
+    constexpr uint64_t SEED = 1234;
+    constexpr size_t TERMS = 5000;
+
+    // Header fields the corruption tests patch, as byte offsets (see VocabFileHeader)
+    constexpr size_t VERSION_AT = 8;
+    constexpr size_t INDEX_SLOTS_AT = 40;
+    constexpr size_t OFFSETS_OFFSET_AT = 64;
+    constexpr size_t RANKS_OFFSET_AT = 72;
+    constexpr size_t INDEX_OFFSET_AT = 96;
+
+    std::string TermText(size_t i) { return "term" + std::to_string(i * 7919 % 100003); }
+
+    std::string TempPath() {
+        char path[] = "/tmp/vocabulary_file_test.XXXXXX";
+        int fd = mkstemp(path);
+        if (fd >= 0) close(fd);
+        return path;
+    }
+
+    std::vector<char> ReadBytes(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), {});
+    }
+
+    void WriteBytes(const std::string& path, const std::vector<char>& bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    template <typename T>
+    T Get(const std::vector<char>& bytes, size_t at) {
+        T value;
+        std::memcpy(&value, bytes.data() + at, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void Put(std::vector<char>& bytes, size_t at, T value) {
+        std::memcpy(bytes.data() + at, &value, sizeof(T));
+    }
+
+    // Writes TERMS terms with doc_freqs[id] = id % 97 and returns the file's bytes
+    std::vector<char> WriteSample(const std::string& path) {
+        ConcurrentVocabulary vocabulary(SEED);
+        std::vector<uint32_t> doc_freqs(1);
+        for (size_t i = 0; i < TERMS; ++i) {
+            const TermID id = vocabulary.Intern(TermText(i));
+            doc_freqs.push_back(id % 97);
+        }
+        CHECK(MappedVocabulary::Write(path, vocabulary, doc_freqs, 777));
+        return ReadBytes(path);
+    }
+
+    void TestRoundTrip() {
+        const std::string path = TempPath();
+        WriteSample(path);
+        auto saved = MappedVocabulary::Open(path);
+        CHECK(saved != nullptr);
+        if (!saved) return;
+
+        CHECK_EQ(saved->size(), TERMS);
+        CHECK_EQ(saved->Seed(), SEED);
+        CHECK_EQ(saved->TotalDocs(), 777u);
+        CHECK_EQ(saved->DocFreqs().size(), TERMS + 1);
+        for (TermID id = 1; id <= TERMS; ++id) {
+            const std::string term = TermText(id - 1);
+            CHECK(saved->Term(id) == term);
+            CHECK_EQ(saved->Hash(id), HashTerm(term, SEED));
+            CHECK_EQ(saved->DocFreqs()[id], id % 97);
+            CHECK_EQ(saved->Find(term, HashTerm(term, SEED)), id);
+        }
+        CHECK_EQ(saved->Find("missing", HashTerm("missing", SEED)), 0u);
+
+        // Layered under a live vocabulary: saved ids are kept, new terms continue after them
+        ConcurrentVocabulary live(SEED, saved.get());
+        CHECK_EQ(live.Find(TermText(41)), 42u);
+        CHECK_EQ(live.Intern(TermText(0)), 1u);
+        CHECK_EQ(live.Intern("fresh"), TERMS + 1);
+        CHECK(live.Term(TERMS + 1) == "fresh");
+        unlink(path.c_str());
+    }
+
+    void TestRejectsDamagedHeader() {
+        const std::string path = TempPath();
+        const std::vector<char> good = WriteSample(path);
+        auto rejected = [&](std::vector<char> bytes) {
+            WriteBytes(path, bytes);
+            // Open reports each rejection on stderr; keep a passing run quiet
+            std::streambuf* saved = std::cerr.rdbuf(nullptr);
+            const bool result = MappedVocabulary::Open(path) == nullptr;
+            std::cerr.rdbuf(saved);
+            return result;
+        };
+
+        CHECK(MappedVocabulary::Open(path + ".missing") == nullptr);
+        CHECK(rejected({}));
+        CHECK(rejected(std::vector<char>(good.begin(), good.begin() + 64)));
+        CHECK(rejected(std::vector<char>(good.begin(), good.end() - 1)));
+
+        std::vector<char> longer = good;
+        longer.push_back(0);
+        CHECK(rejected(longer));
+
+        std::vector<char> magic = good;
+        magic[0] ^= 1;
+        CHECK(rejected(magic));
+
+        std::vector<char> version = good;
+        Put<uint32_t>(version, VERSION_AT, 99);
+        CHECK(rejected(version));
+
+        // A section moved off the layout Write produces
+        std::vector<char> moved = good;
+        Put<uint64_t>(moved, RANKS_OFFSET_AT, Get<uint64_t>(good, RANKS_OFFSET_AT) + 8);
+        CHECK(rejected(moved));
+
+        // Offsets that do not start at 0 or end at the blob size
+        const size_t offsets = Get<uint64_t>(good, OFFSETS_OFFSET_AT);
+        std::vector<char> first = good;
+        Put<uint64_t>(first, offsets, 3);
+        CHECK(rejected(first));
+        std::vector<char> last = good;
+        Put<uint64_t>(last, offsets + TERMS * sizeof(uint64_t), 1);
+        CHECK(rejected(last));
+
+        WriteBytes(path, good);
+        CHECK(MappedVocabulary::Open(path) != nullptr);
+        unlink(path.c_str());
+    }
+
+    void TestDamagedEntriesStayInBounds() {
+        const std::string path = TempPath();
+        std::vector<char> bytes = WriteSample(path);
+        const size_t offsets = Get<uint64_t>(bytes, OFFSETS_OFFSET_AT);
+        const size_t ranks = Get<uint64_t>(bytes, RANKS_OFFSET_AT);
+
+        // Id 1 points past the last rank; the term of rank 10 ends past the blob and the
+        // one of rank 20 ends before it starts
+        Put<uint32_t>(bytes, ranks + 1 * sizeof(uint32_t), 0xFFFF'FFFF);
+        Put<uint64_t>(bytes, offsets + 11 * sizeof(uint64_t), uint64_t{1} << 40);
+        Put<uint64_t>(bytes, offsets + 21 * sizeof(uint64_t), 0);
+        WriteBytes(path, bytes);
+
+        auto saved = MappedVocabulary::Open(path);
+        CHECK(saved != nullptr);
+        if (!saved) return;
+        size_t empty = 0;
+        for (TermID id = 1; id <= TERMS; ++id) empty += saved->Term(id).empty();
+        CHECK(saved->Term(1).empty());
+        CHECK_EQ(empty, 4u); // Id 1 and the ids of ranks 10, 11 and 20
+        CHECK_EQ(saved->Find(TermText(0), HashTerm(TermText(0), SEED)), 0u);
+        CHECK_EQ(saved->Find(TermText(1), HashTerm(TermText(1), SEED)), 2u);
+        unlink(path.c_str());
+    }
+
+    // An index with no empty slot (every entry a foreign tag) still ends each lookup
+    void TestFullIndexTerminates() {
+        const std::string path = TempPath();
+        std::vector<char> bytes = WriteSample(path);
+        const size_t index = Get<uint64_t>(bytes, INDEX_OFFSET_AT);
+        const size_t slots = Get<uint64_t>(bytes, INDEX_SLOTS_AT);
+        for (size_t slot = 0; slot < slots; ++slot) {
+            Put<uint64_t>(bytes, index + slot * sizeof(uint64_t), (uint64_t{0xFFFF'FFFF} << 32) | 1);
+        }
+        WriteBytes(path, bytes);
+
+        auto saved = MappedVocabulary::Open(path);
+        CHECK(saved != nullptr);
+        if (!saved) return;
+        CHECK_EQ(saved->Find(TermText(5), HashTerm(TermText(5), SEED)), 0u);
+        CHECK_EQ(saved->Find("missing", HashTerm("missing", SEED)), 0u);
+        CHECK(saved->Term(6) == TermText(5)); // The other sections are intact
+        unlink(path.c_str());
+    }
+
+} // namespace
+
+int main() {
+    TestRoundTrip();
+    TestRejectsDamagedHeader();
+    TestDamagedEntriesStayInBounds();
+    TestFullIndexTerminates();
+    return Hyperion::Test::TestResult();
+}
@@ -0,0 +1,214 @@
+// Vocabulary and StopwordSet: interning against a reference map across table growth,
+// and a stopword set that answers exactly, with no false positives. ConcurrentVocabulary:
+// many threads interning the same terms agree on their ids while readers walk 1..size().
+
+#include "core/Vocabulary.hpp"
+#include "core/FeatureHash.hpp"
+#include "Check.hpp"
+
+#include <atomic>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace Hyperion;
+
+namespace {
+
+    void TestInternFindGrow() {
+        Vocabulary vocabulary;
+        std::unordered_map<std::string, TermID> reference;
+        std::mt19937 rng(5);
+
+        // Short words over a small alphabet: plenty of repeats, and far more terms than
+        // the initial table holds, so it grows several times
+        for (int i = 0; i < 300000; ++i) {
+            std::string term;
+            for (int n = 1 + rng() % 10; n > 0; --n) term.push_back(static_cast<char>('a' + rng() % 6));
+            const TermID expected = static_cast<TermID>(reference.size() + 1);
+            const auto [it, inserted] = reference.emplace(term, expected);
+            const TermID id = vocabulary.Intern(term);
+            CHECK_EQ(id, it->second);
+            if (id != it->second) return;
+        }
+        CHECK_EQ(vocabulary.size(), reference.size());
+        CHECK_EQ(vocabulary.NextID(), reference.size() + 1);
+
+        // Every earlier term is still found, and its view survived the growth
+        for (const auto& [term, id] : reference) {
+            CHECK_EQ(vocabulary.Find(term), id);
+            CHECK(vocabulary.Term(id) == term);
+        }
+        CHECK_EQ(vocabulary.Find("zzz"), 0u);
+        CHECK_EQ(vocabulary.Find(""), 0u);
+        CHECK(vocabulary.Term(0).empty());
+        CHECK(vocabulary.Term(static_cast<TermID>(reference.size() + 1)).empty());
+
+        vocabulary.clear();
+        CHECK_EQ(vocabulary.size(), 0u);
+        CHECK_EQ(vocabulary.Find("abc"), 0u);
+        CHECK_EQ(vocabulary.Intern("abc"), 1u);
+    }
+
+    void TestInternAs() {
+        Vocabulary vocabulary;
+        CHECK(vocabulary.InternAs("alpha", 1));
+        CHECK(vocabulary.InternAs("gamma", 4)); // Gaps are allowed
+        CHECK(!vocabulary.InternAs("beta", 4)); // Id taken
+        CHECK(!vocabulary.InternAs("alpha", 7)); // Term taken
+        CHECK_EQ(vocabulary.Find("gamma"), 4u);
+        CHECK(vocabulary.Term(4) == "gamma");
+        CHECK(vocabulary.Term(2).empty());
+        CHECK_EQ(vocabulary.Intern("delta"), 5u); // Continues after the largest id
+    }
+
+    const std::vector<std::string_view> WORDS = {
+        "the", "of", "and", "a", "to", "in", "is", "you", "that", "it",
+        "he", "was", "for", "on", "are", "as", "with", "his", "they", "i"
+    };
+
+    void TestStopwordsExact() {
+        const StopwordSet stopwords(WORDS);
+        const std::set<std::string, std::less<>> reference(WORDS.begin(), WORDS.end());
+        auto agrees = [&](std::string_view token) { return stopwords.contains(token) == reference.contains(token); };
+
+        for (std::string_view word : WORDS) CHECK(stopwords.contains(word));
+        CHECK(!stopwords.contains(""));
+
+        // Every string of up to four letters: all neighbours of the (short) stopwords
+        const std::string letters = "abcdefghijklmnopqrstuvwxyz";
+        size_t mismatches = 0;
+        std::string token;
+        for (size_t length = 1; length <= 4; ++length) {
+            std::vector<size_t> digits(length, 0);
+            token.assign(length, 'a');
+            for (;;) {
+                if (!agrees(token)) ++mismatches;
+                size_t d = 0;
+                while (d < length && ++digits[d] == letters.size()) digits[d++] = 0;
+                if (d == length) break;
+                for (size_t k = 0; k < length; ++k) token[k] = letters[digits[k]];
+            }
+        }
+        CHECK_EQ(mismatches, 0u);
+
+        // Each stopword with one byte changed, added or cut, and random longer tokens
+        // (including over-long ones sharing a stopword's first eight bytes)
+        std::mt19937_64 rng(11);
+        for (std::string_view word : WORDS) {
+            for (size_t at = 0; at <= word.size(); ++at) {
+                for (int byte = 1; byte < 256; ++byte) {
+                    std::string changed(word);
+                    if (at < word.size()) {
+                        changed[at] = static_cast<char>(byte);
+                        CHECK(agrees(changed));
+                    }
+                    std::string longer(word);
+                    longer.insert(at, 1, static_cast<char>(byte));
+                    CHECK(agrees(longer));
+                }
+                std::string shorter(word);
+                if (at < word.size()) CHECK(agrees(shorter.erase(at, 1)));
+            }
+            CHECK(!stopwords.contains(std::string(word) + "xxxxxxxx"));
+        }
+        for (int i = 0; i < 200000; ++i) {
+            std::string random(1 + rng() % 12, ' ');
+            for (char& c : random) c = static_cast<char>(1 + rng() % 255);
+            CHECK(agrees(random));
+        }
+    }
+
+    void TestStopwordsRejectLongWords() {
+        bool threw = false;
+        try {
+            StopwordSet stopwords({"ninechars"});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    void TestConcurrentIntern() {
+        constexpr uint64_t SEED = 42;
+        constexpr int THREADS = 4;
+        constexpr size_t INTERNS = 200000;
+        ConcurrentVocabulary vocabulary(SEED);
+
+        // Distinct words, visited by each thread in its own order; far more than the
+        // shards' initial tables, so they grow while other threads probe them
+        std::vector<std::string> words(100000);
+        for (size_t i = 0; i < words.size(); ++i) {
+            std::string word = "w";
+            word += std::to_string(i);
+            words[i] = std::move(word);
+        }
+
+        std::vector<std::vector<TermID>> ids(THREADS, std::vector<TermID>(words.size(), 0));
+        std::atomic<size_t> errors{0};
+        std::atomic<bool> interning{true};
+
+        // Ids 1..size() are readable and round-trip through Find at any moment
+        std::jthread reader([&] {
+            while (interning.load(std::memory_order_relaxed)) {
+                const size_t size = vocabulary.size();
+                for (size_t id = size > 64 ? size - 64 : 1; id <= size; ++id) {
+                    const std::string_view term = vocabulary.Term(static_cast<TermID>(id));
+                    if (term.empty() || vocabulary.Find(term) != id) errors.fetch_add(1);
+                }
+            }
+        });
+
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&, t] {
+                for (size_t k = 0; k < INTERNS; ++k) {
+                    const size_t i = (k * 7919 + t * 104729) % words.size();
+                    const TermID id = vocabulary.Intern(words[i]);
+                    if (id == 0 || (ids[t][i] != 0 && ids[t][i] != id) ||
+                        vocabulary.Term(id) != words[i] || vocabulary.Hash(id) != HashTerm(words[i], SEED)) {
+                        errors.fetch_add(1);
+                    }
+                    ids[t][i] = id;
+                }
+            });
+        }
+        threads.clear();
+        interning.store(false, std::memory_order_relaxed);
+        reader.join();
+        CHECK_EQ(errors.load(), 0u);
+
+        // Every thread got the same id for a word, and ids are dense and unique
+        std::vector<bool> used(words.size() + 1, false);
+        size_t distinct = 0;
+        for (size_t i = 0; i < words.size(); ++i) {
+            TermID id = 0;
+            for (int t = 0; t < THREADS; ++t) {
+                if (ids[t][i] == 0) continue;
+                CHECK(id == 0 || ids[t][i] == id);
+                id = ids[t][i];
+            }
+            if (id == 0) continue;
+            CHECK(id <= words.size() && !used[id]);
+            if (id <= words.size()) used[id] = true;
+            ++distinct;
+        }
+        CHECK_EQ(vocabulary.size(), distinct);
+        CHECK_EQ(vocabulary.Find("never-interned"), 0u);
+    }
+
+} // namespace
+
+int main() {
+    TestInternFindGrow();
+    TestInternAs();
+    TestStopwordsExact();
+    TestStopwordsRejectLongWords();
+    TestConcurrentIntern();
+    return Hyperion::Test::TestResult();
+}